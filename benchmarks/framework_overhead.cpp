@@ -0,0 +1,150 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+// framework_overhead: cost of benchmarked's own machinery, checked against thresholds so that it does not regress.
+//
+//   framework_overhead [<threshold scale>]
+//
+// Measures the per-iteration cost of Benchmark::Launch() (clean up call, fixture calls, timers, storing the result),
+//  the cost of reading the timers, of code benchmark scopes and spans at 1..N threads and the time the reporters
+//  need for 1M samples. Exits with 1 if any measurement exceeds its threshold times the scale (default 1 or
+//  $BENCHMARKED_THRESHOLD_SCALE), so slow CI machines can relax all thresholds at once. The thresholds are 2-4 times
+//  the values measured on a single core x86-64 VM, so a regression of that size is caught.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmarked/benchmarked.h"
+
+namespace {
+
+constexpr uint64_t kIterations = 1'000'000;
+constexpr uint64_t kTimerReads = 1'000'000;
+constexpr uint64_t kScopesPerThread = 200'000;
+constexpr int kRepetitions = 3;
+
+using Clock = std::chrono::steady_clock;
+
+class EmptyBenchmark : public benchmarked::Benchmark {
+ public:
+  using Benchmark::Benchmark;
+
+ protected:
+  void Run() override {}
+};
+
+struct Measurement {
+  std::string name;
+  double value;
+  double limit;
+  std::string unit;
+};
+
+// _____________________________________________________________________________________________________________________
+template<typename F>
+double Elapsed_ns(F &&f) {
+  auto start = Clock::now();
+  f();
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename F>
+double BestOf_ns(F &&f) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < kRepetitions; ++i) { best = std::min(best, Elapsed_ns(f)); }
+  return best;
+}
+
+// _____________________________________________________________________________________________________________________
+// wall time per start/stop pair, averaged over all threads running them concurrently
+template<typename F>
+double ConcurrentPairs_ns(unsigned threads, F &&pair) {
+  return BestOf_ns([&]() {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+      workers.emplace_back([&]() {
+        for (uint64_t i = 0; i < kScopesPerThread; ++i) { pair(); }
+      });
+    }
+    for (auto &worker: workers) { worker.join(); }
+  }) / kScopesPerThread;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+int main(int argc, char **argv) {
+  double scale = 1;
+  if (argc > 1) {
+    scale = std::stod(argv[1]);
+  } else if (const char *env = std::getenv("BENCHMARKED_THRESHOLD_SCALE")) {
+    scale = std::stod(env);
+  }
+  std::vector<Measurement> measurements;
+
+  EmptyBenchmark empty("empty", "self", "empty Run()", kIterations);
+  // Launch() is only public on the base class, the launcher calls it through BenchmarkBase as well
+  benchmarked::BenchmarkBase &base = empty;
+  double launch_ns = Elapsed_ns([&]() { base.Launch(); });
+  measurements.push_back({"Launch() per iteration", launch_ns / kIterations, 2000, "ns"});
+
+  measurements.push_back({"WallTimer start/stop", BestOf_ns([]() {
+    timed::WallTimer timer;
+    for (uint64_t i = 0; i < kTimerReads; ++i) {
+      timer.start();
+      timer.stop();
+    }
+  }) / kTimerReads, 250, "ns"});
+  measurements.push_back({"CPUTimer start/stop", BestOf_ns([]() {
+    timed::CPUTimer timer;
+    for (uint64_t i = 0; i < kTimerReads; ++i) {
+      timer.start();
+      timer.stop();
+    }
+  }) / kTimerReads, 1500, "ns"});
+
+  unsigned maxThreads = std::max(2U, std::min(8U, std::thread::hardware_concurrency()));
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    // contention grows with the threads sharing the handler, the limits grow with it
+    double limit = 1000.0 * threads;
+    measurements.push_back({"thread wall scope, " + std::to_string(threads) + " threads",
+                            ConcurrentPairs_ns(threads, []() {
+                              CODE_BENCHMARK_THREAD_WALL_START("framework_overhead");
+                              CODE_BENCHMARK_THREAD_WALL_STOP("framework_overhead");
+                            }), limit, "ns"});
+    measurements.push_back({"span, " + std::to_string(threads) + " threads",
+                            ConcurrentPairs_ns(threads, []() {
+                              auto span = CODE_BENCHMARK_SPAN_START("framework_overhead");
+                              CODE_BENCHMARK_SPAN_STOP(span);
+                            }), limit / 2, "ns"});
+  }
+
+  std::stringstream sink;
+  benchmarked::ConsoleReporter console(sink);
+  measurements.push_back({"ConsoleReporter, 1M samples",
+                          Elapsed_ns([&]() { console.ReportBenchmark(&empty); }) / 1e6, 500, "ms"});
+  benchmarked::CSVReporter csv(sink);
+  measurements.push_back({"CSVReporter, 1M samples",
+                          Elapsed_ns([&]() { csv.ReportBenchmark(&empty); }) / 1e6, 500, "ms"});
+
+  bool passed = true;
+  std::cout << std::left << std::setw(36) << "measurement" << std::right << std::setw(14) << "value"
+            << std::setw(14) << "limit" << "\n";
+  for (const auto &m: measurements) {
+    bool ok = m.value <= m.limit * scale;
+    passed = passed && ok;
+    std::cout << std::left << std::setw(36) << m.name << std::right << std::setw(11) << m.value << " " << m.unit
+              << std::setw(11) << m.limit * scale << " " << m.unit << (ok ? "" : "  EXCEEDED") << "\n";
+  }
+  std::cout << std::flush;
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+// instrumentation_overhead: cost of a code benchmark scope whose category is disabled, i.e. of the START_IN/STOP_IN
+//  pair around a scope compared to the same loop without them. Exits with 1 if it exceeds 1 ns per scope.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include "benchmarked/benchmarked.h"
+
+CODE_BENCHMARK_CATEGORY(overhead);
+
+namespace {
+
+constexpr uint64_t kScopes = 200'000'000;
+constexpr int kRepetitions = 5;
+constexpr double kLimit_ns = 1.0;
+
+// the empty asm with a memory clobber keeps the loops from being folded and forces the flag to be reloaded
+// _____________________________________________________________________________________________________________________
+__attribute__((noinline)) void Baseline(uint64_t scopes) {
+  for (uint64_t i = 0; i < scopes; ++i) {
+    asm volatile("" : : : "memory");
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+__attribute__((noinline)) void DisabledScopes(uint64_t scopes) {
+  for (uint64_t i = 0; i < scopes; ++i) {
+    CODE_BENCHMARK_WALL_START_IN(overhead, "scope");
+    asm volatile("" : : : "memory");
+    CODE_BENCHMARK_WALL_STOP_IN(overhead, "scope");
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+double NanosecondsPerScope(void (*loop)(uint64_t)) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < kRepetitions; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    loop(kScopes);
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / kScopes);
+  }
+  return best;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+int main() {
+  benchmarked::Categories::Disable("overhead");
+  double baseline = NanosecondsPerScope(Baseline);
+  double disabled = NanosecondsPerScope(DisabledScopes);
+  double overhead = std::max(0.0, disabled - baseline);
+  std::cout << "empty loop:      " << baseline << " ns per iteration\n"
+            << "disabled scope:  " << disabled << " ns per iteration\n"
+            << "overhead:        " << overhead << " ns per scope (limit " << kLimit_ns << " ns)" << std::endl;
+  return overhead <= kLimit_ns ? 0 : 1;
+}
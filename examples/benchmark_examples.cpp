@@ -3,6 +3,21 @@
 
 #include <thread>
 #include <chrono>
+#include <numeric>
+#include <vector>
+#include <deque>
+#include <list>
+#include <optional>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
 
 #include "benchmarked/benchmarked.h"
 
@@ -35,4 +50,174 @@ BENCHMARK_FIXTURE(ExampleFixture, "search for keyword", "example", "search using
   _haystack.find(_needle);
 }
 
+class VectorFixture : public virtual benchmarked::Fixture {
+ protected:
+  std::vector<int> _data;
+
+  void SetUp() override {
+    _data.resize(1 << 20, 1);
+  }
+};
+
+BENCHMARK_FIXTURE(VectorFixture, "sum vector", "example", "sum 4 MiB of ints with hot and cold caches", 5,
+                  benchmarked::BenchmarkOptions{.coldCache = true}) {
+  [[maybe_unused]] volatile long sum = std::accumulate(_data.begin(), _data.end(), 0L);
+}
+
+BENCHMARK("sleep open-loop", "example", "sleep for 1 ms at increasing poisson arrival rates", 200,
+          benchmarked::BenchmarkOptions{.openLoopRate = 250, .arrival = benchmarked::Arrival::Poisson}) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+BENCHMARK_ASYNC("async sleep", "example", "sleep for 1 ms with 32 operations in flight", 3,
+                benchmarked::BenchmarkOptions{.asyncOperations = 256, .asyncConcurrency = 32}) {
+  co_await benchmarked::SleepFor(std::chrono::milliseconds(1));
+}
+
+BENCHMARK("paused sleep", "example", "sleep for 100 ms of which 50 ms are excluded from timing", 5) {
+  PauseTiming();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ResumeTiming();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+void sumForward() {
+  std::vector<int> data(1 << 16, 1);
+  [[maybe_unused]] volatile long sum = std::accumulate(data.begin(), data.end(), 0L);
+}
+
+void sumBackward() {
+  std::vector<int> data(1 << 16, 1);
+  [[maybe_unused]] volatile long sum = std::accumulate(data.rbegin(), data.rend(), 0L);
+}
+
+BENCHMARK_COMPARE(sumForward, sumBackward, "sum direction", "example", "sum a vector forward and backward", 50);
+
+BENCHMARK("sleep with timeout", "example", "sleep for 100 ms, but stop after 300 ms", 50,
+          benchmarked::BenchmarkOptions{.benchmarkTimeout = std::chrono::milliseconds(300)}) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+template<typename Container>
+class ContainerFixture : public virtual benchmarked::Fixture {
+ protected:
+  Container _container;
+
+  void Reset() override {
+    _container.clear();
+  }
+};
+
+BENCHMARK_TEMPLATE(ContainerFixture, (std::vector<int>, std::deque<int>, std::list<int>), "push_back", "example",
+                   "append 100000 ints", 5) {
+  for (int i = 0; i < 100000; ++i) {
+    this->_container.push_back(i);
+  }
+}
+
+class ShuffledFixture : public benchmarked::PipelinedFixture<std::vector<int>> {
+ protected:
+  std::vector<int> Prepare() override {
+    std::vector<int> keys(1 << 20);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), _rng);
+    return keys;
+  }
+
+  std::mt19937 _rng{42};
+};
+
+BENCHMARK_FIXTURE(ShuffledFixture, "sort shuffled", "example", "sort 1M ints shuffled on a background thread", 5) {
+  std::sort(CurrentInput().begin(), CurrentInput().end());
+}
+
+class ListFixture : public benchmarked::AllocatorFixture {
+ protected:
+  std::optional<std::pmr::list<int>> _list;
+
+  void Initialize() override {
+    _list.emplace(_memoryResource);
+  }
+
+  void Reset() override {
+    _list.reset();
+  }
+};
+
+BENCHMARK_ALLOCATORS(ListFixture, "list push_back", "example", "append 100000 ints to a pmr list", 5) {
+  for (int i = 0; i < 100000; ++i) {
+    _list->push_back(i);
+  }
+}
+
+BENCHMARK_PROCESS(("true"), "start true", "example", "start and wait for the true command", 20);
+
+class SharedMapFixture : public virtual benchmarked::Fixture {
+ protected:
+  std::map<int, int> _map;
+  std::shared_mutex _mutex;
+
+  void SetUp() override {
+    for (int i = 0; i < 1000; ++i) { _map[i] = i; }
+  }
+};
+
+BENCHMARK_ROLES_FIXTURE(SharedMapFixture, "shared map", "example", "4 readers and 1 writer of a locked map", 3,
+                        benchmarked::BenchmarkOptions{.roleDuration = std::chrono::milliseconds(200)}) {
+  AddRole("reader", 4, [this](unsigned index) {
+    std::shared_lock locker(_mutex);
+    if (_map.count(static_cast<int>(index * 7 % 1000)) == 0) { throw std::logic_error("missing key"); }
+  });
+  AddRole("writer", 1, [this](unsigned) {
+    std::unique_lock locker(_mutex);
+    _map[42]++;
+  });
+}
+
+class DatasetFixture : public virtual benchmarked::Fixture {
+ protected:
+  std::unique_ptr<benchmarked::Dataset> _dataset;
+  std::span<const uint64_t> _values;
+
+  void SetUp() override {
+    // generated on the first run only, later runs map the cached file
+    _dataset = std::make_unique<benchmarked::Dataset>(benchmarked::DatasetKey{"example-iota", 0, 1},
+                                                      [](benchmarked::DatasetWriter &writer) {
+      std::vector<uint64_t> values(1 << 22);
+      std::iota(values.begin(), values.end(), 0);
+      writer.Write(values);
+    });
+    _values = _dataset->Get<uint64_t>(0, _dataset->Size() / sizeof(uint64_t));
+  }
+};
+
+BENCHMARK_FIXTURE(DatasetFixture, "sum dataset", "example", "sum 32 MiB of cached generated data", 5) {
+  if (std::accumulate(_values.begin(), _values.end(), uint64_t{0}) == 0) { throw std::logic_error("empty dataset"); }
+}
+
+class FileFixture : public virtual benchmarked::Fixture {
+ protected:
+  std::string _path = "/tmp/benchmarked-example-file";
+  std::vector<char> _buffer = std::vector<char>(1 << 20);
+
+  void SetUp() override {
+    std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+    for (int i = 0; i < 16; ++i) { file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size())); }
+  }
+
+  void Initialize() override {
+    benchmarked::EvictPageCache(_path);
+  }
+
+  void CleanUp() override {
+    std::remove(_path.c_str());
+  }
+};
+
+BENCHMARK_FIXTURE(FileFixture, "read file", "example", "read 16 MiB from a file evicted from the page cache", 5,
+                  benchmarked::BenchmarkOptions{.ioAccounting = true}) {
+  std::ifstream file(_path, std::ios::binary);
+  while (file.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()))) {}
+}
+
 BENCHMARK_MAIN()
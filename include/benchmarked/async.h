@@ -0,0 +1,191 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "benchmarked/benchmark_base.h"
+#include "benchmarked/fixture.h"
+
+#ifndef BENCHMARKED_ASYNC_H_
+#define BENCHMARKED_ASYNC_H_
+
+namespace benchmarked {
+
+/**
+ * Task: lazily started coroutine. The body of an async benchmark is a Task, other Tasks can be awaited inside it.
+ */
+class Task {
+ public:
+  struct promise_type {
+    // resumed when this task has finished
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  Task() = default;
+  explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+  Task(const Task&) = delete;
+  Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+  ~Task() { if (_handle) { _handle.destroy(); } }
+
+  Task& operator=(const Task&) = delete;
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (_handle) { _handle.destroy(); }
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+
+  // awaiting a task starts it and resumes the awaiting coroutine once it has finished
+  bool await_ready() const noexcept { return !_handle || _handle.done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    _handle.promise().continuation = awaiting;
+    return _handle;
+  }
+  void await_resume() const {
+    if (_handle.promise().exception) { std::rethrow_exception(_handle.promise().exception); }
+  }
+
+  [[nodiscard]] std::coroutine_handle<promise_type> Handle() const { return _handle; }
+
+ private:
+  std::coroutine_handle<promise_type> _handle = nullptr;
+};
+
+/**
+ * Executor: resumes coroutines of async benchmarks. Implement this to drive benchmarks by your own event loop.
+ */
+class Executor {
+ public:
+  Executor() = default;
+  virtual ~Executor() = default;
+
+  // resume handle as soon as possible
+  virtual void Post(std::coroutine_handle<> handle) = 0;
+  // resume handle not before time
+  virtual void PostAt(std::chrono::steady_clock::time_point time, std::coroutine_handle<> handle) = 0;
+  // resume posted coroutines until no more work is pending
+  virtual void Run() = 0;
+
+  // executor of the async benchmark running on this thread, nullptr if none is running
+  static Executor* Current();
+  static void SetCurrent(Executor* executor);
+};
+
+/**
+ * EventLoop: built-in single threaded executor.
+ *
+ * Not thread-safe.
+ */
+class EventLoop : public Executor {
+ public:
+  EventLoop() = default;
+  EventLoop(const EventLoop&) = delete;
+  EventLoop(EventLoop&&) = delete;
+  ~EventLoop() override = default;
+
+  EventLoop& operator=(const EventLoop&) = delete;
+  EventLoop& operator=(EventLoop&&) = delete;
+
+  void Post(std::coroutine_handle<> handle) override;
+  void PostAt(std::chrono::steady_clock::time_point time, std::coroutine_handle<> handle) override;
+  void Run() override;
+
+ private:
+  struct Timer {
+    std::chrono::steady_clock::time_point time;
+    uint64_t sequence;
+    std::coroutine_handle<> handle;
+
+    bool operator>(const Timer& other) const {
+      return time != other.time ? time > other.time : sequence > other.sequence;
+    }
+  };
+
+  std::deque<std::coroutine_handle<>> _ready;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<>> _timers;
+  uint64_t _sequence = 0;
+};
+
+/**
+ * Awaitable that suspends the awaiting coroutine and posts it to the current executor again, so that the other
+ *  operations in flight can make progress.
+ */
+struct Yield {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const { Executor::Current()->Post(handle); }
+  void await_resume() const noexcept {}
+};
+
+/**
+ * Awaitable that resumes the awaiting coroutine on the current executor once duration has passed.
+ */
+struct SleepFor {
+  explicit SleepFor(std::chrono::nanoseconds duration) : duration(duration) {}
+
+  bool await_ready() const noexcept { return duration.count() <= 0; }
+  void await_suspend(std::coroutine_handle<> handle) const {
+    Executor::Current()->PostAt(std::chrono::steady_clock::now() + duration, handle);
+  }
+  void await_resume() const noexcept {}
+
+  std::chrono::nanoseconds duration;
+};
+
+/**
+ * AsyncBenchmark: benchmark whose body is a coroutine. Each iteration runs BenchmarkOptions::asyncOperations
+ *  operations (calls of Run()) with BenchmarkOptions::asyncConcurrency of them in flight at any time. The latency of
+ *  every single operation is recorded next to the cpu and wall time of the whole iteration.
+ */
+class AsyncBenchmark : public BenchmarkBase, public virtual Fixture {
+ public:
+  explicit AsyncBenchmark(const std::string &name,
+                          const std::string &type = "",
+                          const std::string &description = "",
+                          uint64_t iterations = 1,
+                          BenchmarkOptions options = {},
+                          std::function<void()> cleanUp = []() {}) : BenchmarkBase(name, type, description,
+                                                                                   iterations, std::move(cleanUp),
+                                                                                   std::move(options)) {}
+  AsyncBenchmark(const AsyncBenchmark &) = delete;
+  AsyncBenchmark(AsyncBenchmark &&) = delete;
+  ~AsyncBenchmark() override = default;
+  AsyncBenchmark &operator=(const AsyncBenchmark &) = delete;
+  AsyncBenchmark &operator=(AsyncBenchmark &&) = delete;
+
+ protected:
+  virtual Task Run() = 0;
+
+ private:
+  void Launch() override;
+  // runs operations one after another until all operations of the iteration were started
+  Task Lane(uint64_t &next, uint64_t operations, std::vector<uint64_t> &latencies_ns);
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_ASYNC_H_
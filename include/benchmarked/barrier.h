@@ -3,39 +3,62 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
-#ifndef BENCHMARKER_BARRIER_H_
-#define BENCHMARKER_BARRIER_H_
+#ifndef BENCHMARKED_BARRIER_H_
+#define BENCHMARKED_BARRIER_H_
 
 namespace benchmarked {
 
 /**
  * Any thread registered for this barrier must stop here until all other threads have reached this barrier
  *
+ * Waiting threads spin (with a pause instruction) for up to spinTime and then park on a futex, so threads that
+ *  arrive shortly before the last one are released within nanoseconds instead of waiting to be woken up by the
+ *  scheduler. The last thread only issues a wake-up system call if a thread has parked. Threads do not spin if there
+ *  are more of them than cores.
+ *
+ * The delay between the arrival of the last thread and every other thread leaving Wait() is measured: Skew() is the
+ *  largest one of the most recent generation.
+ *
  * Thread-safe.
  */
 class Barrier {
  public:
   /// \param threads: count of threads to wait at this barrier
-  explicit Barrier(unsigned threads) noexcept;
+  /// \param spinTime: time to spin before parking
+  explicit Barrier(unsigned threads, std::chrono::nanoseconds spinTime = std::chrono::microseconds(100));
   Barrier(const Barrier&) = delete;
   Barrier(Barrier&&) = delete;
 
   Barrier& operator=(const Barrier&) = delete;
   Barrier& operator=(Barrier&&) = delete;
 
+  /// true for exactly one thread per generation (the last one arriving)
   bool Wait() noexcept;
 
+  /// threads waiting for the current generation to complete
+  [[nodiscard]] unsigned Waiting() const { return _arrived.load(std::memory_order_acquire); }
+  /// start skew of the most recent generation in nanoseconds, complete once all of its threads have left Wait()
+  [[nodiscard]] int64_t Skew() const { return _skew_ns.load(std::memory_order_relaxed); }
+
  private:
-  std::mutex _mutex;
-  std::condition_variable _condVar;
-  int _counter = 0;
-  int _generation = 0;
-  unsigned _threads = 0;
+  void Park(uint32_t generation) noexcept;
+  void WakeAll() noexcept;
+
+  const unsigned _threads;
+  const std::chrono::nanoseconds _spinTime;
+  // the generation is the futex word and changes once per completed Wait(), separated from the arrival counter so
+  //  that spinning threads are not disturbed by arriving ones
+  alignas(64) std::atomic<uint32_t> _generation{0};
+  alignas(64) std::atomic<unsigned> _arrived{0};
+  std::atomic<unsigned> _parked{0};
+  std::atomic<int64_t> _release_ns{0};
+  std::atomic<int64_t> _skew_ns{0};
 };
 
 }  // benchmarked
 
-#endif //BENCHMARKER_BARRIER_H_
+#endif //BENCHMARKED_BARRIER_H_
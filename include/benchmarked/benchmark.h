@@ -3,10 +3,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <ctime>
 #include <chrono>
+#include <utility>
+#include <stdexcept>
+#include <optional>
 
 #include <boost/chrono.hpp>
 
@@ -14,6 +19,12 @@
 
 #include "benchmarked/fixture.h"
 #include "benchmarked/benchmark_base.h"
+#include "benchmarked/cache.h"
+#include "benchmarked/event_ring.h"
+#include "timed/Timer.h"
+#include "benchmarked/histogram.h"
+#include "benchmarked/memory.h"
+#include "benchmarked/pipeline.h"
 
 namespace benchmarked {
 
@@ -25,6 +36,13 @@ class Benchmark : public BenchmarkBase, public virtual Fixture {
                      uint64_t iterations = 1,
                      std::function<void()> cleanUp = []() {}) : BenchmarkBase(name, type, description, iterations,
                                                                               std::move(cleanUp)) {}
+  Benchmark(const std::string &name,
+            const std::string &type,
+            const std::string &description,
+            uint64_t iterations,
+            BenchmarkOptions options,
+            std::function<void()> cleanUp = []() {}) : BenchmarkBase(name, type, description, iterations,
+                                                                     std::move(cleanUp), std::move(options)) {}
   Benchmark(const Benchmark &) = delete;
   Benchmark(Benchmark &&) = delete;
   ~Benchmark() override = default;
@@ -34,10 +52,59 @@ class Benchmark : public BenchmarkBase, public virtual Fixture {
  protected:
   virtual void Run() = 0;
 
+  /**
+   * Exclude code inside Run() from the measurement (e.g. regenerating input or verifying output):
+   * \code{.cpp}
+   * BENCHMARK("name", "type", "description", 10) {
+   *   PauseTiming();
+   *   shuffle(keys);
+   *   ResumeTiming();
+   *   lookup(keys);
+   * }
+   * The time between both calls is subtracted from the cpu and wall time of the iteration, as is the measured cost
+   *  of the pause/resume calls themselves. Both are measured with the timers of the iteration.
+   *
+   * Has no effect in open-loop mode (BenchmarkOptions::openLoopRate): the latency of an operation is measured from
+   *  its scheduled start, a pause would only shift the schedule.
+   */
+  void PauseTiming();
+  void ResumeTiming();
+
  private:
+  // timing state of the running iteration, see PauseTiming()
+  struct PauseState {
+    bool timing = false;
+    bool paused = false;
+    // running while paused, the same clocks as the timers of the iteration
+    timed::WallTimer wallPause;
+    timed::CPUTimer cpuPause;
+    int64_t paused_wall_ns = 0;
+    double paused_cpu_ns = 0;
+    uint64_t pauses = 0;
+  };
+
   void Launch() override;
+  // runs a single iteration including fixture calls, evicts the caches before timing if an evictor is provided
+  Result LaunchIteration(CacheEvictor *evictor);
+  // measures the part of a PauseTiming()/ResumeTiming() pair that is not excluded from the timed region
+  void CalibratePauseOverhead();
+  // schedules Run() calls at increasing rates until saturation, see BenchmarkOptions::openLoopRate
+  void LaunchOpenLoop();
+  LoadPoint LaunchOpenLoopStep(double rate);
+
+  PauseState _pause;
+  // this benchmark if it is a PipelinedFixture, set by Launch()
+  InputPipeline *_pipeline = nullptr;
+  // this benchmark if it is an AllocatorFixture, set by Launch()
+  AllocatorFixture *_allocatorFixture = nullptr;
+  bool _pauseCalibrated = false;
+  double _pauseOverhead_wall_ns = 0;
+  double _pauseOverhead_cpu_ns = 0;
 };
 
+// runs callback when the calling thread exits
+void AtThreadExit(std::function<void()> callback);
+
 /**
  * dynamic code benchmark base class
  * @tparam TimePoint
@@ -54,30 +121,106 @@ class CodeBenchmark {
   CodeBenchmark &operator=(const CodeBenchmark &) = delete;
   CodeBenchmark &operator=(CodeBenchmark &&) = delete;
 
-  virtual void start() = 0;
-  virtual void stop() = 0;
+  // strict: starting while the calling thread has an open interval and stopping without one throw std::logic_error.
+  //  Otherwise the open interval is dropped by start() and stop() does nothing (for scopes of a category toggled
+  //  between the two calls).
+  virtual void start(bool strict) = 0;
+  virtual void stop(bool strict) = 0;
+
+  // total time of the closed intervals per thread in nanoseconds, threads that have exited are summed up under
+  //  std::thread::id()
+  [[maybe_unused]] [[nodiscard]] virtual std::map<std::thread::id, double> getResults() const {
+    std::unique_lock locker(_pushToResultPairsMutex);
+    std::map<std::thread::id, double> result;
+    for (const auto &[thread_id, histogram]: _histograms) { result[thread_id] = histogram.Sum(); }
+    return result;
+  }
 
-  [[maybe_unused]] [[nodiscard]] virtual std::map<std::thread::id, double> getResults() const = 0;
+  // call count and latency distribution of the intervals of all threads
+  [[nodiscard]] LatencyHistogram getHistogram() const {
+    std::unique_lock locker(_pushToResultPairsMutex);
+    LatencyHistogram merged;
+    for (const auto &[thread_id, histogram]: _histograms) { merged.Merge(histogram); }
+    return merged;
+  }
+
+  // intervals are also published to the EventRing under this id
+  void setEventId(uint32_t eventId) { _eventId.store(eventId, std::memory_order_relaxed); }
+  [[nodiscard]] uint32_t getEventId() const { return _eventId.load(std::memory_order_relaxed); }
 
  protected:
-  std::mutex _pushToResultPairsMutex;
-  std::map<std::thread::id, std::vector<std::pair<TimePoint, TimePoint>>> _resultPairs;
+  // start of the open interval of a thread, empty if none is open. Called by start() and stop() with the lock held.
+  std::optional<TimePoint> &OpenInterval(const std::thread::id &thread_id) {
+    auto [it, inserted] = _openIntervals.try_emplace(thread_id);
+    if (inserted && thread_id != std::thread::id()) { AtThreadExit([this, thread_id]() { ThreadExited(thread_id); }); }
+    return it->second;
+  }
+
+  // called by start() with the lock held
+  void Open(const std::thread::id &thread_id, const TimePoint &now, bool strict) {
+    auto &start = OpenInterval(thread_id);
+    if (start && strict) {
+      throw std::logic_error("Starting code benchmark failed, since there already is a timer running for this thread "
+                             "on this benchmark id.");
+    }
+    start = now;
+  }
+
+  // called by stop() with the lock held, empty if the thread has no open interval and strict is false
+  std::optional<TimePoint> Close(const std::thread::id &thread_id, bool strict) {
+    auto &start = OpenInterval(thread_id);
+    if (!start && strict) {
+      throw std::logic_error("Stopping code benchmark failed, since this benchmark id has not started a timer on this "
+                             "thread yet.");
+    }
+    return std::exchange(start, std::nullopt);
+  }
+
+  // called by stop() with the lock held
+  void Record(const std::thread::id &thread_id, uint64_t duration_ns) {
+    _histograms[thread_id].Record(duration_ns);
+    if (auto eventId = getEventId(); eventId != ring::kNoName) { EventRing::Get()->Publish(eventId, duration_ns); }
+  }
+
+  // the entries of an exited thread are folded into the ones of std::thread::id(), so the maps do not grow with the
+  //  number of threads that ever used this scope
+  void ThreadExited(const std::thread::id &thread_id) {
+    std::unique_lock locker(_pushToResultPairsMutex);
+    _openIntervals.erase(thread_id);
+    auto it = _histograms.find(thread_id);
+    if (it == _histograms.end()) { return; }
+    _histograms[std::thread::id()].Merge(it->second);
+    _histograms.erase(it);
+  }
+
+  mutable std::mutex _pushToResultPairsMutex;
+  // start of the open interval per thread, closed intervals are only kept in _histograms
+  std::map<std::thread::id, std::optional<TimePoint>> _openIntervals;
+  // one histogram per running thread (and one for all exited ones), filled by stop() and merged at report time
+  std::map<std::thread::id, LatencyHistogram> _histograms;
+  // set when the scope is created or, if the EventRing is enabled later, by CodeBenchmarkHandler::AssignEventIds()
+  std::atomic<uint32_t> _eventId{ring::kNoName};
 };
 
 template<typename T>
 std::ostream &operator<<(std::ostream &os, const CodeBenchmark<T> &c_bm) {
-  os << c_bm._resultPairs.size() << " " << (c_bm._resultPairs.size() == 1 ? "thread" : "threads") << ":\n";
+  auto results = c_bm.getResults();
+  os << results.size() << " " << (results.size() == 1 ? "thread" : "threads") << ":\n";
   double total = 0;
-  for (const auto &[thread_id, time]: c_bm.getResults()) {
+  for (const auto &[thread_id, time]: results) {
     total += time;
-    if (c_bm._resultPairs.size() > 1) {
+    if (results.size() > 1) {
       os << "  " << time / 1000.0 / 1000.0 << " ms\n";
     }
   }
-  if (c_bm._resultPairs.size() > 1) {
+  if (results.size() > 1) {
     os << "  --------\n";
   }
-  os << "  " << total / 1000.0 / 1000.0 << " ms" << std::endl;
+  os << "  " << total / 1000.0 / 1000.0 << " ms\n";
+  auto histogram = c_bm.getHistogram();
+  os << "  calls: " << histogram.Count() << ", mean: " << histogram.Mean() / 1000.0 << " us, p50: "
+     << histogram.Percentile(50) / 1000.0 << " us, p99: " << histogram.Percentile(99) / 1000.0 << " us, max: "
+     << static_cast<double>(histogram.Max()) / 1000.0 << " us" << std::endl;
   return os;
 }
 
@@ -90,10 +233,8 @@ class CodeBenchmarkThreadCPU : public CodeBenchmark<boost::chrono::thread_clock:
   CodeBenchmarkThreadCPU &operator=(const CodeBenchmarkThreadCPU &) = delete;
   CodeBenchmarkThreadCPU &operator=(CodeBenchmarkThreadCPU &&) = delete;
 
-  void start() override;
-  void stop() override;
-
-  [[nodiscard]] std::map<std::thread::id, double> getResults() const override;
+  void start(bool strict) override;
+  void stop(bool strict) override;
 };
 
 
@@ -105,10 +246,8 @@ class CodeBenchmarkTotalCPU : public CodeBenchmark<std::clock_t> {
   CodeBenchmarkTotalCPU &operator=(const CodeBenchmarkTotalCPU &) = delete;
   CodeBenchmarkTotalCPU &operator=(CodeBenchmarkTotalCPU &&) = delete;
 
-  void start() override;
-  void stop() override;
-
-  [[nodiscard]] std::map<std::thread::id, double> getResults() const override;
+  void start(bool strict) override;
+  void stop(bool strict) override;
 };
 
 class CodeBenchmarkThreadWall : public CodeBenchmark<std::chrono::time_point<std::chrono::steady_clock>> {
@@ -119,10 +258,8 @@ class CodeBenchmarkThreadWall : public CodeBenchmark<std::chrono::time_point<std
   CodeBenchmarkThreadWall &operator=(const CodeBenchmarkThreadWall &) = delete;
   CodeBenchmarkThreadWall &operator=(CodeBenchmarkThreadWall &&) = delete;
 
-  void start() override;
-  void stop() override;
-
-  [[nodiscard]] std::map<std::thread::id, double> getResults() const override;
+  void start(bool strict) override;
+  void stop(bool strict) override;
 };
 
 
@@ -134,10 +271,89 @@ class CodeBenchmarkWall : public CodeBenchmark<std::chrono::time_point<std::chro
   CodeBenchmarkWall &operator=(const CodeBenchmarkWall &) = delete;
   CodeBenchmarkWall &operator=(CodeBenchmarkWall &&) = delete;
 
-  void start() override;
-  void stop() override;
+  void start(bool strict) override;
+  void stop(bool strict) override;
+};
+
 
-  [[nodiscard]] std::map<std::thread::id, double> getResults() const override;
+class SpanSite;
+
+/**
+ * Span: handle of one open wall time interval of a SpanSite. It is move-only, so every interval is stopped at most
+ *  once: it may be moved to another thread and stopped there. Stopping a default constructed, moved-from or already
+ *  stopped span does nothing; a span that is still open when it is destroyed or another one is moved into it is
+ *  stopped first.
+ */
+class Span {
+  friend class SpanSite;
+
+ public:
+  Span() = default;
+  Span(const Span &) = delete;
+  Span(Span &&other) noexcept : _site(std::exchange(other._site, nullptr)), _start(other._start) {}
+  ~Span() { Stop(); }
+  Span &operator=(const Span &) = delete;
+  Span &operator=(Span &&other) {
+    if (this != &other) {
+      Stop();
+      _site = std::exchange(other._site, nullptr);
+      _start = other._start;
+    }
+    return *this;
+  }
+
+  void Stop();
+
+ private:
+  Span(SpanSite *site, std::chrono::steady_clock::time_point start) : _site(site), _start(start) {}
+
+  SpanSite *_site = nullptr;
+  std::chrono::steady_clock::time_point _start;
+};
+
+/**
+ * SpanSite: all spans of one name. Starting and stopping spans only touches atomics, so any number of overlapping
+ *  spans may be open at the same time on any threads.
+ *
+ * Thread-safe.
+ */
+class SpanSite {
+  friend class Span;
+
+ public:
+  SpanSite() = default;
+  SpanSite(const SpanSite &) = delete;
+  SpanSite(SpanSite &&) = delete;
+  SpanSite &operator=(const SpanSite &) = delete;
+  SpanSite &operator=(SpanSite &&) = delete;
+
+  [[nodiscard]] Span Start();
+
+  // spans are also published to the EventRing under this id
+  void setEventId(uint32_t eventId) { _eventId.store(eventId, std::memory_order_relaxed); }
+  [[nodiscard]] uint32_t getEventId() const { return _eventId.load(std::memory_order_relaxed); }
+
+  [[nodiscard]] LatencyHistogram getHistogram() const { return _histogram.Snapshot(); }
+  // spans started but not stopped (yet)
+  [[nodiscard]] uint64_t getOpen() const {
+    return _started.load(std::memory_order_relaxed) - _histogram.Snapshot().Count();
+  }
+
+ private:
+  std::atomic<uint64_t> _started{0};
+  ConcurrentLatencyHistogram _histogram;
+  std::atomic<uint32_t> _eventId{ring::kNoName};
+};
+
+
+/**
+ * Cumulative latency distribution of one code benchmark scope at the time of CodeBenchmarkHandler::Snapshot().
+ */
+struct ScopeSnapshot {
+  std::string name;
+  // thread_cpu, total_cpu, thread_wall, wall or span
+  std::string clock;
+  LatencyHistogram histogram;
 };
 
 
@@ -149,12 +365,31 @@ class CodeBenchmarkHandler {
 
   [[nodiscard]] std::string Report(const std::string &fmt = "console") const;
 
-  void start(const std::string &name, uint8_t _bm_t_id);
+  // strict: see CodeBenchmark::start()
+  void start(const std::string &name, uint8_t _bm_t_id, bool strict = true);
+
+  void stop(const std::string &name, uint8_t _bm_t_id, bool strict = true);
 
-  void stop(const std::string &name, uint8_t _bm_t_id);
+  // the site is created on first use and never moves, so callers may keep the reference
+  SpanSite &span(const std::string &name);
+
+  // histograms of all scopes, may be called while other threads keep measuring
+  [[nodiscard]] std::vector<ScopeSnapshot> Snapshot() const;
 
  private:
-  CodeBenchmarkHandler() = default;
+  CodeBenchmarkHandler();
+
+  // name ids for the scopes created before the EventRing was enabled
+  void AssignEventIds(EventRing *eventRing);
+
+  // existing scopes are looked up under the shared lock, new ones are inserted under the exclusive lock
+  template<typename T>
+  T &Lookup(std::map<const std::string, T> &benchmarks, const std::string &name, const std::string &clock);
+
+  mutable std::shared_mutex _benchmarksMutex;
+
+  mutable std::mutex _spansMutex;
+  std::map<const std::string, SpanSite> _spans;
 
   std::map<const std::string, CodeBenchmarkThreadCPU> _threadCPU_benchmarks;
   std::map<const std::string, CodeBenchmarkTotalCPU> _totalCPU_benchmarks;
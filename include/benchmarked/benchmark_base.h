@@ -7,15 +7,26 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <chrono>
 #include <functional>
+#include <mutex>
+#include <optional>
 
 #include "timed/TimeUtils.h"
 
+#include "benchmarked/histogram.h"
+#include "benchmarked/io.h"
+#include "benchmarked/statistics.h"
+#include "benchmarked/watchdog.h"
+
 #ifndef BENCHMARKED_BENCHMARK_BASE_H_
 #define BENCHMARKED_BENCHMARK_BASE_H_
 
 namespace benchmarked {
 
+class Executor;
+
 struct Result {
   Result(timed::Time cpu, timed::Time wall) {
     cpuTime = cpu;
@@ -26,28 +37,217 @@ struct Result {
   timed::Time wallTime;
 };
 
+/**
+ * Results of a benchmark that were measured under different conditions than the default results (e.g. with cold
+ *  caches). They are reported next to the default results.
+ */
+struct Variant {
+  std::string label;
+  std::vector<Result> results;
+};
+
+/**
+ * One point of a latency-vs-offered-load curve measured in open-loop mode.
+ */
+struct LoadPoint {
+  double offeredRate = 0;   // scheduled operations per second
+  double achievedRate = 0;  // completed operations per second
+  // the operations were completed more than 10% later than the schedule of the step allows
+  bool saturated = false;
+  // latency of every operation, measured from its intended (scheduled) start
+  std::vector<uint64_t> latencies_ns;
+};
+
+/**
+ * Resource usage of one run of an external process benchmark (see ProcessBenchmark).
+ */
+struct ProcessRun {
+  uint64_t user_ns = 0;
+  uint64_t sys_ns = 0;
+  uint64_t peakRss_kb = 0;  // peak resident set size, 0 if it did not exceed the one of the benchmark process
+};
+
+/**
+ * Operations of one thread role of a RoleBenchmark, accumulated over all iterations.
+ */
+struct RoleResult {
+  std::string name;
+  unsigned threads = 0;
+  uint64_t operations = 0;
+  int64_t wall_ns = 0;  // duration of all iterations the role ran in
+  LatencyHistogram latencies;
+};
+
+// inter-arrival distribution of operations in open-loop mode
+enum class Arrival {
+  Fixed,
+  Poisson
+};
+
+/**
+ * Per benchmark options. Designated initializers keep the benchmark macros readable:
+ * \code{.cpp}
+ * BENCHMARK("name", "type", "description", 10, benchmarked::BenchmarkOptions{.coldCache = true}) { ... }
+ */
+struct BenchmarkOptions {
+  // additionally run every iteration with evicted data caches and report hot and cold timings side by side
+  bool coldCache = false;
+  // map fresh pages for the eviction buffer before every cold iteration, so that the TLBs are cold as well
+  bool remapColdCache = false;
+
+  // open-loop mode: instead of running iterations back to back, `iterations` Run() calls are scheduled at a target
+  //  rate (operations per second, 0 disables the mode). The rate is multiplied by openLoopRateFactor after each step
+  //  until the step is saturated (the last operation completes more than 10% later than the schedule of the step
+  //  allows) or openLoopMaxSteps were measured. Initialize() and Reset() run once per step, not per operation.
+  //  Can not be combined with coldCache, such a benchmark is rejected when it is registered.
+  double openLoopRate = 0;
+  double openLoopRateFactor = 2;
+  unsigned openLoopMaxSteps = 10;
+  Arrival arrival = Arrival::Fixed;
+  // threads calling Run() concurrently in open-loop mode, Run() must be thread-safe if this is greater than 1
+  unsigned openLoopWorkers = 1;
+
+  // async benchmarks: operations per iteration and how many of them are in flight at the same time
+  uint64_t asyncOperations = 1000;
+  uint64_t asyncConcurrency = 1;
+  // drives async benchmarks instead of the built-in single threaded EventLoop
+  std::shared_ptr<Executor> executor;
+
+  // time limits (0 = none). A benchmark exceeding benchmarkTimeout stops after the running iteration and keeps the
+  //  results collected so far. A single iteration exceeding iterationTimeout (or running for more than twice the
+  //  benchmarkTimeout) can not be interrupted: the launcher then reports everything collected so far and exits.
+  std::chrono::milliseconds iterationTimeout{0};
+  std::chrono::milliseconds benchmarkTimeout{0};
+
+  // benchmarks with a PipelinedFixture: inputs prepared ahead of the measured iteration
+  std::size_t pipelineDepth = 2;
+
+  // process benchmarks: unmeasured runs before the measured ones, a command (argv) run unmeasured before every run
+  //  (e.g. to drop the page cache) and whether the output of the command is shown instead of discarded
+  unsigned processWarmup = 1;
+  std::vector<std::string> processPrepare;
+  bool processOutput = false;
+
+  // role benchmarks: all role threads of an iteration stop after roleDuration (0 = no time limit) or as soon as
+  //  every role with an operation limit has completed it
+  std::chrono::milliseconds roleDuration{1000};
+
+  // record the I/O of the process (/proc/self/io) during every iteration and report logical and device throughput
+  bool ioAccounting = false;
+};
+
 class BenchmarkBase {
   friend class Launcher;
   friend class LauncherConsole;
   friend class ConsoleReporter;
   friend class CSVReporter;
+  friend class HistoryReporter;
   friend class JSONReporter;
   friend class CompareReporter;
+  friend class Checkpoint;
+  friend class RecordedBenchmark;
  public:
-  explicit BenchmarkBase(const std::string &name, const std::string &type, const std::string &description, uint64_t iterations, std::function<void()> cleanUp)
-    : _name(name), _type(type), _description(description), _iterations(iterations), _cleanUp(std::move(cleanUp)) {}
+  explicit BenchmarkBase(const std::string &name, const std::string &type, const std::string &description, uint64_t iterations, std::function<void()> cleanUp,
+                         BenchmarkOptions options = {})
+    : _name(name), _type(type), _description(description), _iterations(iterations), _cleanUp(std::move(cleanUp)),
+      _options(std::move(options)) {}
   virtual ~BenchmarkBase() = default;
 
   virtual void Launch() = 0;
 
+  // benchmarks of the same group (e.g. one benchmark template instantiated for several types) are compared in a
+  //  table by the CompareReporter
+  void SetGroup(const std::string &group) { _group = group; }
+
  protected:
+  // true (and the benchmark is marked as timed out) if the deadline of the benchmark has passed
+  bool DeadlineReached() {
+    if (Watchdog::Clock::now() < _deadline) { return false; }
+    _timedOut = true;
+    return true;
+  }
+
+  // arm the watchdog for a single iteration: it expires at the iteration timeout or the hard benchmark deadline. It
+  //  is disarmed when the returned WatchdogArm is destroyed.
+  [[nodiscard]] WatchdogArm ArmWatchdog() {
+    auto deadline = _hardDeadline;
+    if (_options.iterationTimeout.count() > 0) {
+      deadline = std::min(deadline, Watchdog::Clock::now() + _options.iterationTimeout);
+    }
+    if (_watchdog == nullptr || deadline == Watchdog::Clock::time_point::max()) { return {}; }
+    return {*_watchdog, deadline};
+  }
+
+  // changes the results below under _resultsMutex: the watchdog copies them while the benchmark is still running
+  template<typename F>
+  void Record(F &&update) {
+    std::unique_lock lock(_resultsMutex);
+    update();
+  }
+
   bool _launched = false;
+  bool _timedOut = false;
+  // not run since an iteration of a benchmark before it exceeded its time limit
+  bool _skipped = false;
+  // set by the Launcher from BenchmarkOptions::benchmarkTimeout and the suite time budget: no iteration is started
+  //  after _deadline, the watchdog expires if the running iteration has not finished at _hardDeadline
+  Watchdog::Clock::time_point _deadline = Watchdog::Clock::time_point::max();
+  Watchdog::Clock::time_point _hardDeadline = Watchdog::Clock::time_point::max();
+  Watchdog *_watchdog = nullptr;
   uint64_t _iterations = 0;
   std::string _name;
   std::string _type;
   std::string _description;
+  std::string _group;
   std::function<void()> _cleanUp;
+  BenchmarkOptions _options;
   std::vector<Result> _results;
+  // label of _results, only shown if there are variants to compare with
+  std::string _resultsLabel = "default";
+  std::vector<Variant> _variants;
+  // ratio (wall time) of the first variant to the default results of a paired comparison
+  std::optional<statistics::Estimate> _comparison;
+  std::vector<LoadPoint> _loadCurve;
+  // latency of every single operation of an async benchmark
+  std::vector<uint64_t> _latencies_ns;
+  // resource usage of every measured run of a process benchmark, in the order of _results
+  std::vector<ProcessRun> _processRuns;
+  // throughput and latency per role of a role benchmark
+  std::vector<RoleResult> _roleResults;
+  // per iteration of a multi-threaded benchmark: time between the release of the first and the last thread
+  std::vector<int64_t> _startSkew_ns;
+  // I/O during every iteration of _results if BenchmarkOptions::ioAccounting is set
+  std::vector<IOCounters> _io;
+  // held while the results are changed (see Record()), never while an iteration runs
+  std::mutex _resultsMutex;
+};
+
+/**
+ * RecordedBenchmark: the results of a benchmark without the code that measured them (restored from a checkpoint or
+ *  copied from a benchmark whose iteration exceeded its time limit), it is only reported.
+ */
+class RecordedBenchmark : public BenchmarkBase {
+ public:
+  RecordedBenchmark() : BenchmarkBase("", "", "", 0, nullptr) {}
+  // the results recorded so far, benchmark may still be running in another thread
+  explicit RecordedBenchmark(BenchmarkBase &benchmark)
+    : BenchmarkBase(benchmark._name, benchmark._type, benchmark._description, benchmark._iterations, nullptr,
+                    benchmark._options) {
+    _group = benchmark._group;
+    std::unique_lock lock(benchmark._resultsMutex);
+    _results = benchmark._results;
+    _resultsLabel = benchmark._resultsLabel;
+    _variants = benchmark._variants;
+    _comparison = benchmark._comparison;
+    _loadCurve = benchmark._loadCurve;
+    _latencies_ns = benchmark._latencies_ns;
+    _processRuns = benchmark._processRuns;
+    _roleResults = benchmark._roleResults;
+    _startSkew_ns = benchmark._startSkew_ns;
+    _io = benchmark._io;
+  }
+
+  void Launch() override {}
 };
 
 }  // namespace benchmarked
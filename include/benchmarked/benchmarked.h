@@ -3,11 +3,20 @@
 
 #pragma once
 
+#include <cctype>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "benchmarked/launcher.h"
 #include "benchmarked/reporter.h"
 #include "benchmarked/benchmark.h"
+#include "benchmarked/category.h"
+#include "benchmarked/async.h"
+#include "benchmarked/compare.h"
+#include "benchmarked/dataset.h"
+#include "benchmarked/process.h"
+#include "benchmarked/roles.h"
 
 #include "timed/Timer.h"
 
@@ -20,15 +29,86 @@ class BenchmarkRegistrator {
   }
 };
 
+// splits a stringified, parenthesized type list like "(int, std::map<int, int>)" at its top level commas
+inline std::vector<std::string> SplitTypeNames(const std::string &types) {
+  std::vector<std::string> names;
+  std::string current;
+  int depth = 0;
+  for (std::size_t i = 1; i + 1 < types.size(); ++i) {
+    char c = types[i];
+    if (c == '<' || c == '(' || c == '[' || c == '{') { depth++; }
+    if (c == '>' || c == ')' || c == ']' || c == '}') { depth--; }
+    if (c == ',' && depth == 0) {
+      names.push_back(current);
+      current.clear();
+      continue;
+    }
+    if (!(std::isspace(static_cast<unsigned char>(c)) && current.empty())) { current += c; }
+  }
+  names.push_back(current);
+  for (auto &name: names) {
+    while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back()))) { name.pop_back(); }
+  }
+  return names;
+}
+
+/**
+ * Registers one benchmark per type of Types. The benchmarks are named "<name><<type>>" and grouped by name.
+ */
+template<template<typename> class BenchmarkTemplate, typename... Types>
+class TemplateBenchmarkRegistrator {
+ public:
+  template<typename... Args>
+  TemplateBenchmarkRegistrator(const char *typeNames, const std::string &name, Args... args) {
+    auto names = SplitTypeNames(typeNames);
+    std::size_t i = 0;
+    (Register<Types>(name, i < names.size() ? names[i++] : std::to_string(i++), args...), ...);
+  }
+
+ private:
+  template<typename T, typename... Args>
+  static void Register(const std::string &name, const std::string &typeName, Args... args) {
+    LauncherConsole::GetInstance().RegisterBenchmarkBuilder([=]() {
+      auto benchmark = std::make_shared<BenchmarkTemplate<T>>(name + "<" + typeName + ">", args...);
+      benchmark->SetGroup(name);
+      return benchmark;
+    });
+  }
+};
+
+/**
+ * Registers the benchmark once per Allocator. The benchmarks are named "<name><<allocator>>" and grouped by name.
+ */
+template<typename AllocatorBenchmark>
+class AllocatorBenchmarkRegistrator {
+ public:
+  template<typename... Args>
+  explicit AllocatorBenchmarkRegistrator(const std::string &name, Args... args) {
+    for (auto allocator: {Allocator::Malloc, Allocator::Arena, Allocator::Pool}) {
+      LauncherConsole::GetInstance().RegisterBenchmarkBuilder([=]() {
+        auto benchmark = std::make_shared<AllocatorBenchmark>(name + "<" + ToString(allocator) + ">", args...);
+        benchmark->SetAllocator(allocator);
+        benchmark->SetGroup(name);
+        return benchmark;
+      });
+    }
+  }
+};
+
 class CodeBenchmarkRegistrator {
  public:
-  static void start(const std::string &name, uint8_t bm_t_id) {
+  static void start(const std::string &name, uint8_t bm_t_id, bool strict = true) {
+    CodeBenchmarkHandler& instance = CodeBenchmarkHandler::GetInstance();
+    instance.start(name, bm_t_id, strict);
+  }
+  static void stop(const std::string &name, uint8_t bm_t_id, bool strict = true) {
     CodeBenchmarkHandler& instance = CodeBenchmarkHandler::GetInstance();
-    instance.start(name, bm_t_id);
+    instance.stop(name, bm_t_id, strict);
   }
-  static void stop(const std::string &name, uint8_t bm_t_id) {
+
+  static SpanSite &span(const std::string &name) {
     CodeBenchmarkHandler& instance = CodeBenchmarkHandler::GetInstance();
-    instance.stop(name, bm_t_id);
+    return instance.span(name);
   }
 
   static std::string report(const std::string &fmt) {
@@ -42,6 +122,7 @@ class CodeBenchmarkRegistrator {
 #define BENCHMARK_UNIQUE_NAME_LINE2(name, line) name##line
 #define BENCHMARK_UNIQUE_NAME_LINE(name, line) BENCHMARK_UNIQUE_NAME_LINE2(name, line)
 #define BENCHMARK_UNIQUE_NAME(name) BENCHMARK_UNIQUE_NAME_LINE(name, __LINE__)
+#define BENCHMARK_UNPAREN(...) __VA_ARGS__
 
 #define BENCHMARK_MAIN()\
 int main(int argc, char** argv) {\
@@ -86,8 +167,149 @@ Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]()
 }\
 void benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)::Run()
 
+/**
+ * Async benchmark register macro: the body is a coroutine returning benchmarked::Task.
+ * Example usage:
+ * \code{.cpp}
+ * // run 10 iterations of 1000 `asyncOperation` calls each, 16 of them in flight at any time
+ * BENCHMARK_ASYNC("BenchmarkName", "BenchmarkType", "Description", 10,
+ *                 benchmarked::BenchmarkOptions{.asyncOperations = 1000, .asyncConcurrency = 16}) {
+ *   co_await asyncOperation();
+ * }
+ */
+#define BENCHMARK_ASYNC(...)\
+namespace benchmarked {\
+class BENCHMARK_UNIQUE_NAME(__benchmark__) : public AsyncBenchmark {\
+ public:\
+  using AsyncBenchmark::AsyncBenchmark;\
+ protected:\
+  Task Run() override;\
+};\
+Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<BENCHMARK_UNIQUE_NAME(__benchmark__)>(__VA_ARGS__);});\
+}\
+benchmarked::Task benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)::Run()
+
+/**
+ * Paired A/B benchmark register macro: a and b are callables without arguments whose iterations are interleaved.
+ * Example usage:
+ * \code{.cpp}
+ * // compare `sortA` and `sortB` over 100 paired iterations
+ * BENCHMARK_COMPARE(sortA, sortB, "BenchmarkName", "BenchmarkType", "Description", 100);
+ */
+#define BENCHMARK_COMPARE(a, b, ...)\
+namespace benchmarked {\
+Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<CompareBenchmark>([]() { a(); }, []() { b(); }, #a, #b, __VA_ARGS__); });\
+}
+
+/**
+ * External process benchmark register macro: command is the parenthesized argv of the process started per iteration.
+ * Example usage:
+ * \code{.cpp}
+ * // start `git --version` 20 times after one warm-up run and measure it until it exited
+ * BENCHMARK_PROCESS(("git", "--version"), "BenchmarkName", "BenchmarkType", "Description", 20);
+ */
+#define BENCHMARK_PROCESS(command, ...)\
+namespace benchmarked {\
+Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<ProcessBenchmark>(std::vector<std::string>{BENCHMARK_UNPAREN command}, __VA_ARGS__); });\
+}
+
+/**
+ * Role benchmark register macros: the body declares the thread roles with AddRole() and runs once after SetUp().
+ * Example usage:
+ * \code{.cpp}
+ * // 8 readers and 2 writers of `cache` running for 1 s per iteration, throughput and latency reported per role
+ * BENCHMARK_ROLES_FIXTURE(CacheFixture, "BenchmarkName", "BenchmarkType", "Description", 5) {
+ *   AddRole("reader", 8, [this](unsigned) { cache.Get(key()); });
+ *   AddRole("writer", 2, [this](unsigned) { cache.Put(key(), 1); });
+ * }
+ */
+#define BENCHMARK_ROLES(...)\
+namespace benchmarked {\
+class BENCHMARK_UNIQUE_NAME(__benchmark__) : public RoleBenchmark {\
+ public:\
+  using RoleBenchmark::RoleBenchmark;\
+ protected:\
+  void DeclareRoles() override;\
+};\
+Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<BENCHMARK_UNIQUE_NAME(__benchmark__)>(__VA_ARGS__); });\
+}\
+void benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)::DeclareRoles()
+
+#define BENCHMARK_ROLES_FIXTURE(fixture, ...)\
+namespace benchmarked {\
+class BENCHMARK_UNIQUE_NAME(__benchmark__) : public RoleBenchmark, public fixture {\
+ public:\
+  using RoleBenchmark::RoleBenchmark;\
+ protected:\
+  void DeclareRoles() override;\
+};\
+Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<BENCHMARK_UNIQUE_NAME(__benchmark__)>(__VA_ARGS__); });\
+}\
+void benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)::DeclareRoles()
+
+/**
+ * Typed benchmark register macro: registers one benchmark per type of the parenthesized type list, each deriving from
+ *  fixture<Type>. Inside the body, `BenchmarkType` is the current type and fixture members must be accessed via
+ *  `this->` since the fixture is a dependent base class.
+ * Example usage:
+ * \code{.cpp}
+ * template <typename Map>
+ * class MapFixture : public virtual benchmarked::Fixture {
+ *  protected:
+ *   Map map;
+ * };
+ *
+ * // registers "insert<std::map<int, int>>" and "insert<std::unordered_map<int, int>>"
+ * BENCHMARK_TEMPLATE(MapFixture, (std::map<int, int>, std::unordered_map<int, int>), "insert", "type", "desc", 10) {
+ *   for (int i = 0; i < 1000; ++i) { this->map[i] = i; }
+ * }
+ */
+#define BENCHMARK_TEMPLATE(fixture, types, ...)\
+namespace benchmarked {\
+template<typename BenchmarkType>\
+class BENCHMARK_UNIQUE_NAME(__benchmark__) : public Benchmark, public fixture<BenchmarkType> {\
+ public:\
+  using Benchmark::Benchmark;\
+ protected:\
+  void Run() override;\
+};\
+Internal::TemplateBenchmarkRegistrator<BENCHMARK_UNIQUE_NAME(__benchmark__), BENCHMARK_UNPAREN types> BENCHMARK_UNIQUE_NAME(benchmark_registrator)(#types, __VA_ARGS__);\
+}\
+template<typename BenchmarkType>\
+void benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)<BenchmarkType>::Run()
+
+/**
+ * Allocator benchmark register macro: registers the benchmark once with malloc, once with an ArenaResource and once
+ *  with a PoolResource as _memoryResource of the fixture, which must derive from AllocatorFixture. The resource is
+ *  reset after every iteration and the console report compares the three benchmarks side by side.
+ * Example usage:
+ * \code{.cpp}
+ * class ListFixture : public benchmarked::AllocatorFixture {
+ *  protected:
+ *   std::optional<std::pmr::list<int>> list;
+ *   void Initialize() override { list.emplace(_memoryResource); }
+ *   void Reset() override { list.reset(); }
+ * };
+ *
+ * // registers "push_back<malloc>", "push_back<arena>" and "push_back<pool>"
+ * BENCHMARK_ALLOCATORS(ListFixture, "push_back", "type", "desc", 10) {
+ *   for (int i = 0; i < 1000; ++i) { list->push_back(i); }
+ * }
+ */
+#define BENCHMARK_ALLOCATORS(fixture, ...)\
+namespace benchmarked {\
+class BENCHMARK_UNIQUE_NAME(__benchmark__) : public Benchmark, public fixture {\
+ public:\
+  using Benchmark::Benchmark;\
+ protected:\
+  void Run() override;\
+};\
+Internal::AllocatorBenchmarkRegistrator<BENCHMARK_UNIQUE_NAME(__benchmark__)> BENCHMARK_UNIQUE_NAME(benchmark_registrator)(__VA_ARGS__);\
+}\
+void benchmarked::BENCHMARK_UNIQUE_NAME(__benchmark__)::Run()
+
 #define BENCHMARK_CLASS(type, ...)\
-namespace CppBenchmark { Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<type>(__VA_ARGS__); }); }
+namespace benchmarked { Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(benchmark_registrator)([]() { return std::make_shared<type>(__VA_ARGS__); }); }
 
 
 #define BENCHMARKED
@@ -104,6 +326,38 @@ namespace CppBenchmark { Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(be
 #define CODE_BENCHMARK_WALL_START(name) benchmarked::Internal::CodeBenchmarkRegistrator::start(name, 3)
 #define CODE_BENCHMARK_WALL_STOP(name) benchmarked::Internal::CodeBenchmarkRegistrator::stop(name, 3)
 
+// Spans measure wall time intervals that may be stopped on another thread than the one they were started on:
+//   auto span = CODE_BENCHMARK_SPAN_START("request");  ...  CODE_BENCHMARK_SPAN_STOP(span);
+// The site of the name is looked up once per call site, so name must not change between calls of the same site.
+#define CODE_BENCHMARK_SPAN_START(name) [&]() -> benchmarked::SpanSite& {\
+  static benchmarked::SpanSite& site = benchmarked::Internal::CodeBenchmarkRegistrator::span(name);\
+  return site;\
+}().Start()
+#define CODE_BENCHMARK_SPAN_STOP(span) (span).Stop()
+
+// Categories switch groups of scopes on and off at runtime (see benchmarked::Categories). A category is declared once
+// at namespace scope and used by the *_IN variants of the macros in the same namespace:
+//   CODE_BENCHMARK_CATEGORY(storage);
+//   CODE_BENCHMARK_WALL_START_IN(storage, "flush");  ...  CODE_BENCHMARK_WALL_STOP_IN(storage, "flush");
+// While the category is disabled, a scope costs one relaxed load and a branch. A scope whose category is toggled
+// between its start and stop is not measured and does not throw.
+#define CODE_BENCHMARK_CATEGORY(id) inline benchmarked::Category benchmarked_category_##id(#id)
+#define CODE_BENCHMARK_ENABLED(id) __builtin_expect(benchmarked_category_##id.Enabled(), 0)
+#define CODE_BENCHMARK_SCOPE_IN(id, op, name, clock)\
+  do {\
+    if (CODE_BENCHMARK_ENABLED(id)) { benchmarked::Internal::CodeBenchmarkRegistrator::op(name, clock, false); }\
+  } while (0)
+#define CODE_BENCHMARK_THREAD_CPU_START_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, start, name, 0)
+#define CODE_BENCHMARK_THREAD_CPU_STOP_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, stop, name, 0)
+#define CODE_BENCHMARK_TOTAL_CPU_START_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, start, name, 1)
+#define CODE_BENCHMARK_TOTAL_CPU_STOP_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, stop, name, 1)
+#define CODE_BENCHMARK_THREAD_WALL_START_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, start, name, 2)
+#define CODE_BENCHMARK_THREAD_WALL_STOP_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, stop, name, 2)
+#define CODE_BENCHMARK_WALL_START_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, start, name, 3)
+#define CODE_BENCHMARK_WALL_STOP_IN(id, name) CODE_BENCHMARK_SCOPE_IN(id, stop, name, 3)
+#define CODE_BENCHMARK_SPAN_START_IN(id, name)\
+  (CODE_BENCHMARK_ENABLED(id) ? CODE_BENCHMARK_SPAN_START(name) : benchmarked::Span())
+
 #define CODE_BENCHMARK_REPORT(fmt) benchmarked::Internal::CodeBenchmarkRegistrator::report(fmt)
 #else
 // empty definitions
@@ -119,5 +373,20 @@ namespace CppBenchmark { Internal::BenchmarkRegistrator BENCHMARK_UNIQUE_NAME(be
 #define CODE_BENCHMARK_WALL_START(name)
 #define CODE_BENCHMARK_WALL_STOP(name)
 
+#define CODE_BENCHMARK_SPAN_START(name) benchmarked::Span()
+#define CODE_BENCHMARK_SPAN_STOP(span) (void)(span)
+
+#define CODE_BENCHMARK_CATEGORY(id) static_assert(true, "")
+#define CODE_BENCHMARK_ENABLED(id) false
+#define CODE_BENCHMARK_THREAD_CPU_START_IN(id, name)
+#define CODE_BENCHMARK_THREAD_CPU_STOP_IN(id, name)
+#define CODE_BENCHMARK_TOTAL_CPU_START_IN(id, name)
+#define CODE_BENCHMARK_TOTAL_CPU_STOP_IN(id, name)
+#define CODE_BENCHMARK_THREAD_WALL_START_IN(id, name)
+#define CODE_BENCHMARK_THREAD_WALL_STOP_IN(id, name)
+#define CODE_BENCHMARK_WALL_START_IN(id, name)
+#define CODE_BENCHMARK_WALL_STOP_IN(id, name)
+#define CODE_BENCHMARK_SPAN_START_IN(id, name) benchmarked::Span()
+
 #define CODE_BENCHMARK_REPORT(fmt) ""
 #endif
@@ -0,0 +1,48 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstddef>
+
+#ifndef BENCHMARKED_CACHE_H_
+#define BENCHMARKED_CACHE_H_
+
+namespace benchmarked {
+
+/**
+ * CacheEvictor: evicts the CPU data caches by reading a buffer that is twice the size of the last level cache.
+ *  If remap is set, the buffer is unmapped and mapped again before every eviction, so that the pages touched are
+ *  always fresh and the TLBs are cold as well.
+ *
+ * Not thread-safe.
+ */
+class CacheEvictor {
+ public:
+  explicit CacheEvictor(bool remap = false);
+  CacheEvictor(const CacheEvictor&) = delete;
+  CacheEvictor(CacheEvictor&&) = delete;
+  ~CacheEvictor();
+
+  CacheEvictor& operator=(const CacheEvictor&) = delete;
+  CacheEvictor& operator=(CacheEvictor&&) = delete;
+
+  void Evict();
+
+  [[nodiscard]] std::size_t BufferSize() const { return _size; }
+
+  // size of the last level cache in bytes from the environment snapshot or hwinfo (32 MiB if unknown)
+  static std::size_t LastLevelCacheSize();
+
+ private:
+  void Map();
+  void Unmap();
+
+  bool _remap = false;
+  std::size_t _size = 0;
+  char* _buffer = nullptr;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_CACHE_H_
@@ -0,0 +1,50 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef BENCHMARKED_CALIBRATION_H_
+#define BENCHMARKED_CALIBRATION_H_
+
+namespace benchmarked {
+
+/**
+ * HostProfile: results of a short calibration suite (< 2 s) characterizing the machine the benchmarks run on.
+ *  Two hosts with the same hardware description may still differ considerably in these numbers, so they are recorded
+ *  in every report to normalize results or to reject results of hosts that are off-profile.
+ */
+struct HostProfile {
+  // STREAM-style bandwidths in GB/s
+  double copyBandwidth_GBs = 0;
+  double triadBandwidth_GBs = 0;
+  // pointer-chase load latency in ns for working sets fitting into L1, L2, LLC and for main memory
+  double l1Latency_ns = 0;
+  double l2Latency_ns = 0;
+  double llcLatency_ns = 0;
+  double memoryLatency_ns = 0;
+  // uncontended costs in ns
+  double mutex_ns = 0;
+  double atomic_ns = 0;
+  double mallocFree_ns = 0;
+  double syscall_ns = 0;
+  // time it took to run the calibration
+  double duration_ms = 0;
+
+  // (name, value) of all calibration results, this is what reporters write
+  [[nodiscard]] std::vector<std::pair<std::string, double>> Metrics() const;
+  // descriptions of all metrics deviating by more than tolerance (relative, e.g. 0.1) from reference
+  [[nodiscard]] std::vector<std::string> OffProfile(const HostProfile& reference, double tolerance) const;
+
+  // runs the calibration suite once per process and returns the cached results afterwards
+  static const HostProfile& Get();
+  // runs the calibration suite
+  static HostProfile Measure();
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_CALIBRATION_H_
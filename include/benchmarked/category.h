@@ -0,0 +1,84 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARKED_CATEGORY_H_
+#define BENCHMARKED_CATEGORY_H_
+
+namespace benchmarked {
+
+/**
+ * Category: runtime switch for a group of instrumented scopes. Categories are declared at namespace scope with
+ *  CODE_BENCHMARK_CATEGORY(id) and start out disabled unless $BENCHMARKED_CATEGORIES selects them.
+ *
+ * Enabled() is a single relaxed load of a flag that is only written when the selection changes, so a disabled scope
+ *  costs one well predicted branch.
+ *
+ * Thread-safe.
+ */
+class Category {
+ public:
+  explicit Category(const char* name);
+  Category(const Category&) = delete;
+  Category(Category&&) = delete;
+  ~Category();
+
+  Category& operator=(const Category&) = delete;
+  Category& operator=(Category&&) = delete;
+
+  [[nodiscard]] bool Enabled() const { return _enabled.load(std::memory_order_relaxed); }
+  [[nodiscard]] const char* Name() const { return _name; }
+
+ private:
+  friend class Categories;
+
+  const char* _name;
+  std::atomic<bool> _enabled{false};
+};
+
+/**
+ * Categories: selection of the enabled categories. A selection is a comma separated list of category names, "all" or
+ *  "none"; a name prefixed with '-' is disabled (e.g. "all,-storage").
+ */
+class Categories {
+ public:
+  /// replaces the selection, also applied to categories declared later
+  static void Select(const std::string& selection);
+  static void Enable(const std::string& name);
+  static void Disable(const std::string& name);
+  /// names of all declared categories and whether they are enabled
+  static std::vector<std::pair<std::string, bool>> List();
+  /// the current selection, with only the last rule for every name (e.g. "all,-storage")
+  static std::string Selection();
+
+  /**
+   * Replaces the selection with the content of the file at path. The file is only read if it is a regular file (not a
+   *  symbolic link) owned by the user of the process that no one else can read or write (e.g. mode 0600).
+   *
+   * @return false if the file is missing, insecure or unreadable, the selection is then unchanged
+   */
+  static bool Load(const std::string& path);
+
+  /**
+   * On signo, the selection is loaded (see Load()) from path by a background thread. The default path is
+   *  $XDG_RUNTIME_DIR/benchmarked-<pid>.categories, or /tmp/benchmarked-<pid>.categories if $XDG_RUNTIME_DIR is unset:
+   *   (umask 077 && echo storage > $XDG_RUNTIME_DIR/benchmarked-<pid>.categories) && kill -USR2 <pid>
+   */
+  static void InstallSignalHandler(const std::string& path = "", int signo = SIGUSR2);
+
+ private:
+  friend class Category;
+
+  static void Register(Category* category);
+  static void Unregister(Category* category);
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_CATEGORY_H_
@@ -0,0 +1,70 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmarked/benchmark_base.h"
+#include "benchmarked/environment.h"
+
+#ifndef BENCHMARKED_CHECKPOINT_H_
+#define BENCHMARKED_CHECKPOINT_H_
+
+namespace benchmarked {
+
+/**
+ * Checkpoint: append-only file with the results of completed benchmarks. The Launcher appends every benchmark as
+ *  soon as it has finished, so an interrupted suite (e.g. on a preempted CI runner) can be resumed with the benchmarks
+ *  still missing, and the checkpoints of several shards can be merged into one report (benchmarked-merge).
+ *
+ * Every record is appended with a single write() followed by fdatasync(). A record cut off by a crash has no end
+ *  marker: it is ignored by Load() and removed when the file is opened for appending again.
+ *
+ * The first record is preceded by the environment and the host profile of the process writing it, so the merged
+ *  results of several shards can be checked for having been measured on equivalent hosts.
+ *
+ * Not thread-safe.
+ */
+class Checkpoint {
+ public:
+  /// opens (or creates) the file for appending, truncate discards the records already in it
+  explicit Checkpoint(const std::string& path, bool truncate = false);
+  Checkpoint(const Checkpoint&) = delete;
+  Checkpoint(Checkpoint&&) = delete;
+  ~Checkpoint();
+
+  Checkpoint& operator=(const Checkpoint&) = delete;
+  Checkpoint& operator=(Checkpoint&&) = delete;
+
+  /// appends the results of a launched benchmark
+  void Append(const BenchmarkBase& benchmark);
+
+  /**
+   * Benchmarks of all complete records in the file (none if it does not exist), in the order they were first
+   *  appended; a later record of the same benchmark replaces an earlier one. Their Launch() does nothing.
+   */
+  static std::vector<std::shared_ptr<BenchmarkBase>> Load(const std::string& path);
+  /// benchmarks of several checkpoints, a benchmark found in more than one of them is taken from the last one
+  static std::vector<std::shared_ptr<BenchmarkBase>> Merge(const std::vector<std::string>& paths);
+  /// environment and host profile of the process that wrote the first record (empty if there is none)
+  static RecordedEnvironment LoadEnvironment(const std::string& path);
+
+  [[nodiscard]] const std::string& Path() const { return _path; }
+
+ private:
+  // benchmarks of all complete records, complete is set to the size of the file up to the end of the last one
+  static std::vector<std::shared_ptr<BenchmarkBase>> Read(const std::string& path, std::size_t& complete,
+                                                          RecordedEnvironment* environment = nullptr);
+
+  std::string _path;
+  int _fd = -1;
+  // nothing written yet: the next record is preceded by the header
+  bool _empty = false;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_CHECKPOINT_H_
@@ -0,0 +1,43 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "benchmarked/benchmark_base.h"
+
+#ifndef BENCHMARKED_COMPARE_H_
+#define BENCHMARKED_COMPARE_H_
+
+namespace benchmarked {
+
+/**
+ * CompareBenchmark: paired A/B benchmark. Every iteration runs both variants back to back in randomized order on the
+ *  same core, so that both see the same thermal state and background load. The reported ratio B/A is the geometric
+ *  mean of the per-iteration ratios with a bootstrap confidence interval computed from the paired samples.
+ */
+class CompareBenchmark : public BenchmarkBase {
+ public:
+  CompareBenchmark(std::function<void()> a, std::function<void()> b, std::string labelA, std::string labelB,
+                   const std::string &name, const std::string &type = "", const std::string &description = "",
+                   uint64_t iterations = 1, BenchmarkOptions options = {});
+  CompareBenchmark(const CompareBenchmark &) = delete;
+  CompareBenchmark(CompareBenchmark &&) = delete;
+  ~CompareBenchmark() override = default;
+  CompareBenchmark &operator=(const CompareBenchmark &) = delete;
+  CompareBenchmark &operator=(CompareBenchmark &&) = delete;
+
+  void Launch() override;
+
+ private:
+  static Result Measure(const std::function<void()> &f);
+
+  std::function<void()> _a;
+  std::function<void()> _b;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_COMPARE_H_
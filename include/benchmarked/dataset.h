@@ -0,0 +1,141 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef BENCHMARKED_DATASET_H_
+#define BENCHMARKED_DATASET_H_
+
+namespace benchmarked {
+
+// identifies the data of a deterministic generator: change version whenever the generator produces different data
+struct DatasetKey {
+  std::string generator;
+  uint64_t seed = 0;
+  uint32_t version = 1;
+};
+
+struct DatasetOptions {
+  // cache directory, default: $BENCHMARKED_DATASET_CACHE or $XDG_CACHE_HOME/benchmarked/datasets
+  std::string directory;
+  // fault in all pages when mapping (MAP_POPULATE), so the first iteration does not pay for the page faults
+  bool populate = false;
+  // ask for transparent huge pages (madvise, only effective where the kernel supports them for file mappings)
+  bool hugePages = false;
+};
+
+/**
+ * DatasetWriter: appends the data of a dataset while it is generated. The format is flat: store offsets returned by
+ *  Write() instead of pointers, e.g. in a struct written first at offset 0, so the data is valid at any address.
+ */
+class DatasetWriter {
+  friend class Dataset;
+
+ public:
+  DatasetWriter(const DatasetWriter&) = delete;
+  DatasetWriter(DatasetWriter&&) = delete;
+  ~DatasetWriter() = default;
+
+  DatasetWriter& operator=(const DatasetWriter&) = delete;
+  DatasetWriter& operator=(DatasetWriter&&) = delete;
+
+  /// appends count values aligned to alignof(T) and returns their offset
+  template<typename T>
+  uint64_t Write(const T* values, std::size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "Datasets only hold trivially copyable types.");
+    return WriteBytes(values, count * sizeof(T), alignof(T));
+  }
+
+  template<typename T>
+  uint64_t Write(const std::vector<T>& values) { return Write(values.data(), values.size()); }
+
+  /// overwrites already written bytes, e.g. a header at offset 0 whose offsets were only known later
+  void Patch(uint64_t offset, const void* data, std::size_t bytes);
+
+  /// bytes written so far
+  [[nodiscard]] uint64_t Size() const { return _size; }
+
+ private:
+  DatasetWriter(int fd, uint64_t base) : _fd(fd), _base(base) {}
+
+  uint64_t WriteBytes(const void* data, std::size_t bytes, std::size_t alignment);
+  void Flush();
+
+  int _fd;
+  uint64_t _base;  // file offset of the data
+  uint64_t _size = 0;
+  uint64_t _flushed = 0;  // bytes already written to the file, the rest is in _buffer
+  std::vector<char> _buffer;
+};
+
+/**
+ * Dataset: read-only memory mapping of cached generated data.
+ *
+ * The first process asking for a key generates the data and writes it to <directory>/<generator>-<seed>-v<version>;
+ *  later processes (and concurrently running ones, which wait for the generating one) only map the file. The file
+ *  is written under a temporary name and renamed when complete, so an interrupted generation is never used.
+ * \code{.cpp}
+ * void SetUp() override {
+ *   _graph = std::make_unique<benchmarked::Dataset>(benchmarked::DatasetKey{"rmat", 42, 1},
+ *                                                  [](benchmarked::DatasetWriter& writer) {
+ *     writer.Write(generateEdges(42));
+ *   });
+ *   auto edges = _graph->Get<Edge>(0, _graph->Size() / sizeof(Edge));
+ * }
+ * \endcode
+ */
+class Dataset {
+ public:
+  using Generator = std::function<void(DatasetWriter&)>;
+
+  Dataset(const DatasetKey& key, const Generator& generate, const DatasetOptions& options = {});
+  Dataset(const Dataset&) = delete;
+  Dataset(Dataset&&) = delete;
+  ~Dataset();
+
+  Dataset& operator=(const Dataset&) = delete;
+  Dataset& operator=(Dataset&&) = delete;
+
+  /// count values of type T starting at offset, throws std::out_of_range if they exceed the data
+  template<typename T>
+  [[nodiscard]] std::span<const T> Get(uint64_t offset, std::size_t count) const {
+    static_assert(std::is_trivially_copyable_v<T>, "Datasets only hold trivially copyable types.");
+    if (offset > _size || count > (_size - offset) / sizeof(T) || offset % alignof(T) != 0) {
+      throw std::out_of_range("Dataset '" + _path + "' has no aligned range of the requested size at this offset.");
+    }
+    return {reinterpret_cast<const T*>(_data + offset), count};
+  }
+
+  template<typename T>
+  [[nodiscard]] const T& At(uint64_t offset) const { return Get<T>(offset, 1)[0]; }
+
+  [[nodiscard]] const char* Data() const { return _data; }
+  [[nodiscard]] uint64_t Size() const { return _size; }
+  [[nodiscard]] const std::string& Path() const { return _path; }
+  /// false if the data was mapped from the cache, true if it was generated by this process
+  [[nodiscard]] bool Generated() const { return _generated; }
+
+ private:
+  // maps the cached file if it exists and matches the key
+  bool Map(const DatasetKey& key, const DatasetOptions& options);
+  void Generate(const DatasetKey& key, const Generator& generate);
+
+  std::string _path;
+  void* _mapping = nullptr;
+  std::size_t _mappingSize = 0;
+  const char* _data = nullptr;
+  uint64_t _size = 0;
+  bool _generated = false;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_DATASET_H_
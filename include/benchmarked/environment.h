@@ -0,0 +1,71 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef BENCHMARKED_ENVIRONMENT_H_
+#define BENCHMARKED_ENVIRONMENT_H_
+
+namespace benchmarked {
+
+/**
+ * Environment: snapshot of the hard- and software the benchmarks run on, embedded into every report.
+ *  Probing the hardware is slow, so the hardware part is collected only once per boot and cached in
+ *  $XDG_CACHE_HOME/benchmarked/environment (or ~/.cache/...). The cache is invalidated when the boot ID changes.
+ */
+struct Environment {
+  // --- hardware: cached per boot ---
+  std::string bootId;
+  std::string cpuModel;
+  int64_t logicalCores = 0;
+  int64_t physicalCores = 0;
+  int64_t numaNodes = 0;
+  int64_t regularClockSpeed_kHz = 0;
+  int64_t maxClockSpeed_kHz = 0;
+  // (name, size in bytes), e.g. ("L1d", 32768)
+  std::vector<std::pair<std::string, int64_t>> caches;
+  int64_t ramSize_Bytes = 0;
+  std::string kernel;
+
+  // --- software: collected on every run ---
+  std::string compiler;
+  // build type and flags of the benchmarked library, not necessarily the ones of the benchmark binary
+  std::string buildType;
+  std::string buildFlags;
+  // HEAD of the project when it was last built
+  std::string gitSha;
+  std::string cpuGovernor;
+  // values of environment variables that influence performance, see Environment::Collect()
+  std::vector<std::pair<std::string, std::string>> variables;
+
+  // all fields as (name, value) pairs, this is what reporters write
+  [[nodiscard]] std::vector<std::pair<std::string, std::string>> Entries() const;
+
+  // collected once per process, the hardware part is read from the cache file if it is valid
+  static const Environment& Get();
+  // collects everything without using the cache file
+  static Environment Collect();
+};
+
+/**
+ * RecordedEnvironment: Environment::Entries() and HostProfile::Metrics() as recorded by another process (e.g. in a
+ *  checkpoint). Reporters given one report it instead of the environment of the reporting process.
+ */
+struct RecordedEnvironment {
+  std::vector<std::pair<std::string, std::string>> entries;
+  std::vector<std::pair<std::string, double>> hostProfile;
+
+  [[nodiscard]] bool Empty() const { return entries.empty() && hostProfile.empty(); }
+  // descriptions of all entries differing from reference and all host profile metrics deviating by more than
+  //  tolerance (relative, e.g. 0.1) from it
+  [[nodiscard]] std::vector<std::string> Differences(const RecordedEnvironment& reference, double tolerance) const;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_ENVIRONMENT_H_
@@ -0,0 +1,156 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARKED_EVENT_RING_H_
+#define BENCHMARKED_EVENT_RING_H_
+
+namespace benchmarked {
+
+namespace ring {
+
+constexpr char kMagic[8] = {'B', 'M', 'R', 'I', 'N', 'G', '0', '1'};
+constexpr std::size_t kNameLength = 64;
+constexpr uint32_t kNoName = UINT32_MAX;
+
+// one interval; seq is the position in the ring + 1 and written last, so a reader detects slots being overwritten
+struct Slot {
+  std::atomic<uint64_t> seq;
+  std::atomic<uint64_t> nameId;
+  std::atomic<uint64_t> end_ns;  // steady clock at the end of the interval
+  std::atomic<uint64_t> duration_ns;
+};
+
+struct alignas(64) RingHeader {
+  std::atomic<uint64_t> head;  // number of events ever written to this ring
+};
+
+struct alignas(64) FileHeader {
+  char magic[8];
+  int32_t pid;
+  uint32_t maxThreads;
+  uint32_t capacity;  // slots per ring, a power of two
+  uint32_t maxNames;
+  std::atomic<uint32_t> threads;  // rings claimed so far, including the ones released by exited threads
+  std::atomic<uint32_t> names;    // names registered so far
+  std::atomic<uint64_t> unclaimed;  // events dropped because all rings were claimed
+};
+
+// layout of the file: FileHeader | names (maxNames * kNameLength) | rings (maxThreads * (RingHeader | capacity Slots))
+std::size_t NamesOffset();
+std::size_t RingOffset(const FileHeader& header, uint32_t ring);
+std::size_t FileSize(uint32_t maxThreads, uint32_t capacity, uint32_t maxNames);
+
+}  // namespace ring
+
+/**
+ * EventRing: publishes code benchmark intervals into a memory-mapped file (in /dev/shm by default), so that
+ *  benchmarked-ring can aggregate them from another process without pausing or signalling this one.
+ *
+ * Every thread claims its own ring on its first event and is its only producer. A producer never waits for the
+ *  reader: when the reader falls behind, the oldest events are overwritten and the reader counts them as dropped.
+ *  The ring of an exited thread is claimed by the next new thread, which continues its sequence numbers, so a
+ *  reader keeps its position in it. Threads beyond maxThreads running at the same time and names beyond maxNames are
+ *  not published.
+ *
+ * Enabled by Enable() or by setting $BENCHMARKED_EVENT_RING to the file path ("1" for /dev/shm/benchmarked-<pid>).
+ *
+ * Thread-safe.
+ */
+class EventRing {
+ public:
+  /// the ring of this process, nullptr if it is not enabled
+  static EventRing* Get();
+  /// creates the ring (if not enabled yet), an empty path selects /dev/shm/benchmarked-<pid>
+  static EventRing* Enable(const std::string& path = "", uint32_t maxThreads = 64, uint32_t capacity = 4096,
+                           uint32_t maxNames = 256);
+  /// callback is run with the ring once it is enabled (right away if it already is), e.g. to register names
+  static void OnEnable(std::function<void(EventRing*)> callback);
+
+  EventRing(const EventRing&) = delete;
+  EventRing(EventRing&&) = delete;
+  ~EventRing();
+
+  EventRing& operator=(const EventRing&) = delete;
+  EventRing& operator=(EventRing&&) = delete;
+
+  /// id of the scope "<clock>:<name>", ring::kNoName if the name table is full
+  uint32_t NameId(const std::string& clock, const std::string& name);
+  void Publish(uint32_t nameId, uint64_t duration_ns);
+
+  [[nodiscard]] const std::string& Path() const { return _path; }
+
+ private:
+  // the ring of the calling thread, released when the thread exits
+  struct ThreadRing;
+
+  EventRing(std::string path, uint32_t maxThreads, uint32_t capacity, uint32_t maxNames);
+
+  // a ring released by an exited thread or a new one, nullptr if maxThreads rings are in use
+  ring::RingHeader* Claim(uint32_t& index);
+  void Release(uint32_t index);
+  [[nodiscard]] ring::RingHeader* Ring(uint32_t index) const;
+
+  std::string _path;
+  std::size_t _size = 0;
+  ring::FileHeader* _header = nullptr;
+  std::mutex _namesMutex;
+  std::map<std::string, uint32_t> _nameIds;
+  std::mutex _ringsMutex;
+  std::vector<uint32_t> _freeRings;
+  // size of _freeRings, read without the lock by threads that did not get a ring
+  std::atomic<std::size_t> _freeRingCount{0};
+};
+
+/**
+ * One interval read from an EventRing file.
+ */
+struct RingEvent {
+  uint32_t nameId = 0;
+  uint64_t end_ns = 0;
+  uint64_t duration_ns = 0;
+};
+
+/**
+ * EventRingReader: attaches read-only to the file of an EventRing. Only reads, so any number of readers may attach.
+ *
+ * Not thread-safe.
+ */
+class EventRingReader {
+ public:
+  explicit EventRingReader(const std::string& path);
+  EventRingReader(const EventRingReader&) = delete;
+  EventRingReader(EventRingReader&&) = delete;
+  ~EventRingReader();
+
+  EventRingReader& operator=(const EventRingReader&) = delete;
+  EventRingReader& operator=(EventRingReader&&) = delete;
+
+  /// events published since the last call, starting with the ones still in the rings on the first call
+  std::vector<RingEvent> Poll();
+  /// "<clock>:<name>" of a name id
+  [[nodiscard]] std::string Name(uint32_t nameId) const;
+
+  [[nodiscard]] int32_t Pid() const { return _header->pid; }
+  /// events overwritten before they were read plus events of threads that did not get a ring
+  [[nodiscard]] uint64_t Dropped() const { return _dropped + _header->unclaimed.load(std::memory_order_relaxed); }
+
+ private:
+  std::size_t _size = 0;
+  const ring::FileHeader* _header = nullptr;
+  std::vector<uint64_t> _positions;
+  uint64_t _dropped = 0;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_EVENT_RING_H_
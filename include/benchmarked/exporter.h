@@ -0,0 +1,64 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "benchmarked/histogram.h"
+
+#ifndef BENCHMARKED_EXPORTER_H_
+#define BENCHMARKED_EXPORTER_H_
+
+namespace benchmarked {
+
+/**
+ * MetricsExporter: publishes the code benchmark scopes (CODE_BENCHMARK_* and spans) of a long running process in the
+ *  Prometheus text exposition format from a background thread.
+ *
+ * Every interval the exporter snapshots all scopes and renders
+ *  - benchmarked_scope_duration_seconds: cumulative histogram (buckets, sum, count) since the process started,
+ *  - benchmarked_scope_window_*: calls, mean, p50, p99 and max of the intervals closed during the last window.
+ *
+ * The target is either a file, which is replaced atomically (e.g. for the node_exporter textfile collector), or
+ *  "unix:<path>" for a Unix domain socket that sends the latest exposition to every client connecting to it.
+ *  Memory is bounded by the number of scopes: the exporter only keeps the snapshot of the previous window per scope.
+ */
+class MetricsExporter {
+ public:
+  explicit MetricsExporter(std::string target, std::chrono::milliseconds interval = std::chrono::seconds(10));
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter(MetricsExporter&&) = delete;
+  ~MetricsExporter();
+
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+  /// renders the exposition of all scopes and starts a new window
+  std::string Collect();
+
+ private:
+  void Loop();
+  void Publish(const std::string& exposition);
+  void Serve();
+
+  std::string _target;
+  std::string _socketPath;
+  std::chrono::milliseconds _interval;
+  int _listenFd = -1;
+  // the loop waits on the read end, the destructor writes to wake it up
+  int _wakeFds[2] = {-1, -1};
+
+  std::mutex _mutex;
+  std::map<std::string, LatencyHistogram> _previous;
+  std::string _exposition;
+  std::thread _thread;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_EXPORTER_H_
@@ -0,0 +1,90 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef BENCHMARKED_HISTOGRAM_H_
+#define BENCHMARKED_HISTOGRAM_H_
+
+namespace benchmarked {
+
+/**
+ * LatencyHistogram: fixed-size log-linear histogram of nanosecond values. Every power of two is split into
+ *  kSubBuckets linear buckets, so any value up to 2^64 ns is recorded in constant time and with a relative error of
+ *  at most 1 / kSubBuckets. Values below kSubBuckets are recorded exactly.
+ *
+ * Not thread-safe: keep one histogram per thread and Merge() them for reporting, or use ConcurrentLatencyHistogram.
+ */
+class LatencyHistogram {
+  friend class ConcurrentLatencyHistogram;
+  friend class Checkpoint;
+
+ public:
+  static constexpr unsigned kSubBucketBits = 4;
+  static constexpr std::size_t kSubBuckets = 1U << kSubBucketBits;
+  static constexpr std::size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  void Record(uint64_t value_ns);
+  void Merge(const LatencyHistogram& other);
+
+  [[nodiscard]] uint64_t Count() const { return _count; }
+  [[nodiscard]] uint64_t Min() const { return _count == 0 ? 0 : _min; }
+  [[nodiscard]] uint64_t Max() const { return _max; }
+  [[nodiscard]] double Mean() const { return _count == 0 ? 0 : _sum / static_cast<double>(_count); }
+  [[nodiscard]] double Sum() const { return _sum; }
+  /// p-th percentile (0 <= p <= 100): the middle of the bucket holding it, clamped to [Min(), Max()]
+  [[nodiscard]] double Percentile(double p) const;
+  /// number of values below bound_ns, exact if bound_ns is a power of two (a bucket boundary)
+  [[nodiscard]] uint64_t CountBelow(uint64_t bound_ns) const;
+  /// number of values up to and including bound_ns, exact if bound_ns + 1 is a power of two
+  [[nodiscard]] uint64_t CountAtMost(uint64_t bound_ns) const {
+    return bound_ns == UINT64_MAX ? _count : CountBelow(bound_ns + 1);
+  }
+  /// values recorded since this histogram was equal to earlier; min and max are estimated from the buckets
+  [[nodiscard]] LatencyHistogram Since(const LatencyHistogram& earlier) const;
+
+ private:
+  static std::size_t BucketIndex(uint64_t value_ns);
+  static uint64_t BucketLowerBound(std::size_t index);
+
+  uint64_t _count = 0;
+  uint64_t _min = UINT64_MAX;
+  uint64_t _max = 0;
+  double _sum = 0;
+  std::array<uint64_t, kBuckets> _buckets{};
+};
+
+/**
+ * ConcurrentLatencyHistogram: same buckets as LatencyHistogram, but recorded with relaxed atomic operations so that
+ *  any number of threads can Record() into it without locking.
+ *
+ * Thread-safe.
+ */
+class ConcurrentLatencyHistogram {
+ public:
+  ConcurrentLatencyHistogram() = default;
+  ConcurrentLatencyHistogram(const ConcurrentLatencyHistogram&) = delete;
+  ConcurrentLatencyHistogram(ConcurrentLatencyHistogram&&) = delete;
+  ConcurrentLatencyHistogram& operator=(const ConcurrentLatencyHistogram&) = delete;
+  ConcurrentLatencyHistogram& operator=(ConcurrentLatencyHistogram&&) = delete;
+
+  void Record(uint64_t value_ns);
+  /// copy of the current state, not atomic as a whole while other threads are still recording
+  [[nodiscard]] LatencyHistogram Snapshot() const;
+
+ private:
+  std::atomic<uint64_t> _count{0};
+  std::atomic<uint64_t> _min{UINT64_MAX};
+  std::atomic<uint64_t> _max{0};
+  std::atomic<uint64_t> _sum{0};
+  std::array<std::atomic<uint64_t>, LatencyHistogram::kBuckets> _buckets{};
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_HISTOGRAM_H_
@@ -0,0 +1,94 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARKED_HISTORY_H_
+#define BENCHMARKED_HISTORY_H_
+
+namespace benchmarked {
+
+/**
+ * Summary of one benchmark of one run, as stored in the history.
+ */
+struct HistoryRecord {
+  int64_t timestamp = 0;  // seconds since epoch
+  std::string name;       // truncated to 127 characters
+  std::string gitSha;     // truncated to 47 characters
+  uint64_t iterations = 0;
+  double wallMin_ns = 0;
+  double wallMean_ns = 0;
+  double wallMedian_ns = 0;
+  double cpuMedian_ns = 0;
+};
+
+/**
+ * HistoryStore: append-only file of fixed size binary records. The file is memory-mapped for reading and indexed
+ *  by benchmark name and timestamp when it is opened. Appending is done with a single write() on a file opened with
+ *  O_APPEND, so concurrently running benchmark binaries may share one store. A record cut off by a crash is removed
+ *  when the store is opened for writing again.
+ *
+ * Not thread-safe.
+ */
+class HistoryStore {
+ public:
+  // creates the store if it does not exist, unless it is opened read-only
+  explicit HistoryStore(const std::string& path, bool readOnly = false);
+  HistoryStore(const HistoryStore&) = delete;
+  HistoryStore(HistoryStore&&) = delete;
+  ~HistoryStore();
+
+  HistoryStore& operator=(const HistoryStore&) = delete;
+  HistoryStore& operator=(HistoryStore&&) = delete;
+
+  void Append(const HistoryRecord& record);
+
+  // names of all benchmarks in the store
+  [[nodiscard]] std::vector<std::string> Names();
+  // records of benchmark name with from <= timestamp <= to, sorted by timestamp
+  [[nodiscard]] std::vector<HistoryRecord> Query(const std::string& name, int64_t from = 0,
+                                                 int64_t to = std::numeric_limits<int64_t>::max());
+
+ private:
+  // maps the file again if it grew (e.g. by appends of other processes) and indexes the new records
+  void Refresh();
+  [[nodiscard]] HistoryRecord Read(std::size_t index) const;
+
+  std::string _path;
+  bool _readOnly = false;
+  int _fd = -1;
+  const char* _data = nullptr;
+  std::size_t _mappedSize = 0;
+  std::size_t _indexedRecords = 0;
+  // name -> record indices sorted by timestamp
+  std::map<std::string, std::vector<std::size_t>> _index;
+};
+
+/**
+ * A step in the history of a benchmark: the median wall time changed from before_ns to after_ns at record index.
+ */
+struct ChangePoint {
+  std::size_t index = 0;
+  int64_t timestamp = 0;
+  std::string gitSha;
+  double before_ns = 0;
+  double after_ns = 0;
+};
+
+/**
+ * Binary segmentation for shifts of the mean of the median wall times. A split is accepted if its standardized mean
+ *  difference exceeds threshold (noise is estimated robustly from consecutive differences, so a slow drift does not
+ *  inflate it) and the relative change is at least minChange.
+ */
+std::vector<ChangePoint> DetectChangePoints(const std::vector<HistoryRecord>& history, double threshold = 4.0,
+                                            double minChange = 0.01);
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_HISTORY_H_
@@ -0,0 +1,61 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+
+#include <fcntl.h>
+
+#ifndef BENCHMARKED_IO_H_
+#define BENCHMARKED_IO_H_
+
+namespace benchmarked {
+
+/**
+ * I/O counters of this process (all threads) as accounted by the kernel in /proc/self/io. The logical counters
+ *  (rchar, wchar) count every byte passed to read/write-like system calls, the device counters (readBytes,
+ *  writeBytes) only the bytes that caused block device I/O, i.e. that were not served by the page cache.
+ */
+struct IOCounters {
+  uint64_t rchar = 0;
+  uint64_t wchar = 0;
+  uint64_t syscr = 0;
+  uint64_t syscw = 0;
+  uint64_t readBytes = 0;
+  uint64_t writeBytes = 0;
+  // written to the page cache, but truncated or deleted before they were written back
+  uint64_t cancelledWriteBytes = 0;
+
+  /// current counters, std::nullopt if /proc/self/io is not available
+  static std::optional<IOCounters> Read();
+  /// counters in the format of /proc/<pid>/io ("<name>: <value>" per line), unknown names are ignored
+  static IOCounters Parse(std::istream& stream);
+  /// what a Read() adds to the difference of two Read() results (measured once)
+  static const IOCounters& ReadOverhead();
+
+  /// difference, saturating at zero
+  IOCounters operator-(const IOCounters& other) const;
+  IOCounters& operator+=(const IOCounters& other);
+};
+
+/**
+ * Opens path with O_DIRECT, so reads and writes bypass the page cache. Buffers, offsets and sizes must then be
+ *  aligned to the logical block size of the device (4096 is a safe choice). Throws std::runtime_error if the file
+ *  system does not support O_DIRECT.
+ */
+int OpenDirect(const std::string& path, int flags = O_RDONLY, mode_t mode = 0644);
+
+/**
+ * Writes back the dirty pages of the file and drops all of its pages from the page cache, so the next iteration
+ *  reads it from the device again. Pages mapped by a process can not be dropped.
+ */
+void EvictPageCache(const std::string& path);
+void EvictPageCache(int fd);
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_IO_H_
@@ -8,8 +8,12 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include "benchmarked/benchmark_base.h"
+#include "benchmarked/checkpoint.h"
 #include "benchmarked/reporter.h"
 
 #ifndef BENCHMARKED_LAUNCHER_H_
@@ -34,18 +38,53 @@ class Launcher {
   Launcher& operator=(Launcher&&) = delete;
 
   virtual void Launch(const std::string& nameFilter = "", const std::string& typeFilter = "");
+  // throws std::invalid_argument if the options of the benchmark can not be combined
   void RegisterBenchmark(const std::shared_ptr<BenchmarkBase>& benchmark);
   void RegisterBenchmarkBuilder(const std::function<std::shared_ptr<BenchmarkBase>()>& builder);
   void ClearAllBenchmarks();
   void ClearAllBenchmarksBuilders();
+  // total time for all benchmarks of the next Launch() call, shared equally by the benchmarks not run yet
+  void SetTimeBudget(std::chrono::milliseconds budget);
+  // only run shard index (0 based) of count: the benchmarks are distributed so that the shards take about the same
+  //  time according to the runtime estimates (by benchmark name, e.g. from a HistoryStore). The distribution only
+  //  depends on the registered benchmarks, the filters and the estimates, so every shard computes the same one.
+  void SetShard(unsigned index, unsigned count, std::map<std::string, double> runtimeEstimates_ns = {});
+  // append every completed benchmark to this checkpoint file. With resume, the benchmarks already in it are not run
+  //  again but reported with the results from the checkpoint, otherwise the file is truncated.
+  void SetCheckpoint(const std::string& path, bool resume = true);
 
   void Report(std::unique_ptr<Reporter> reporter);
-  //void Compare(std::unique_ptr<CompareReporter> reporter);
+  void Compare(std::unique_ptr<CompareReporter> reporter);
 
  protected:
+  // instantiates the benchmarks of all registered builders
+  void BuildBenchmarks();
+  // the benchmarks of the shard set by SetShard()
+  std::vector<std::shared_ptr<BenchmarkBase>> SelectShard(
+      const std::vector<std::shared_ptr<BenchmarkBase>>& benchmarks) const;
+  // called by the watchdog thread if an iteration exceeds its time limit: replaces the running benchmark by a copy of
+  //  its results marked as timed out, marks the benchmarks not started yet as skipped, calls _timeoutHandler (e.g. to
+  //  report what was collected so far) and exits, since the iteration can not be interrupted
+  [[noreturn]] void OnTimeout();
+
   std::string _name;
   std::vector<std::shared_ptr<BenchmarkBase>> _benchmarks;
   std::vector<std::function<std::shared_ptr<BenchmarkBase>()>> _builders;
+  std::chrono::milliseconds _timeBudget{0};
+  unsigned _shardIndex = 0;
+  unsigned _shardCount = 1;
+  std::map<std::string, double> _runtimeEstimates_ns;
+  std::unique_ptr<Checkpoint> _checkpoint;
+  // the launching thread and the watchdog thread append to _checkpoint
+  std::mutex _checkpointMutex;
+  // benchmarks restored from the checkpoint when resuming, by name and type
+  std::map<std::pair<std::string, std::string>, std::shared_ptr<BenchmarkBase>> _completed;
+  std::atomic<BenchmarkBase*> _running{nullptr};
+  // the benchmarks selected by Launch() and the index of the one launched last, read by OnTimeout() while the
+  //  launching thread is blocked in an iteration
+  std::vector<std::shared_ptr<BenchmarkBase>> _queue;
+  std::atomic<std::size_t> _queuePosition{0};
+  std::function<void()> _timeoutHandler;
 };
 
 
@@ -71,8 +110,14 @@ class LauncherConsole : public Launcher {
   bool _list = false;
   std::string _nameFilter;
   std::string _typeFilter;
-  const std::string _outputType = "console";
-  const std::string _outputFile;
+  std::string _outputType = "console";
+  std::string _outputFile;
+  // environment and host profile of a csv report, default: <_outputFile>.meta.csv or stderr without _outputFile
+  std::string _metadataFile;
+  // summaries of all benchmarks are appended to this HistoryStore if set
+  std::string _historyFile;
+  std::string _checkpointFile;
+  bool _resume = false;
   std::ostream& _ostream = std::cout;
 };
 
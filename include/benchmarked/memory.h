@@ -0,0 +1,157 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "benchmarked/fixture.h"
+
+#ifndef BENCHMARKED_MEMORY_H_
+#define BENCHMARKED_MEMORY_H_
+
+namespace benchmarked {
+
+/**
+ * ArenaResource: bump allocator. Deallocation is a no-op, Reset() makes all memory reusable at once.
+ *
+ * Memory is taken from upstream in chunks of growing size. Reset() merges them into a single chunk, so once the
+ *  arena has seen the peak usage of an iteration, neither allocating nor resetting calls upstream anymore.
+ *
+ * Not thread-safe.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+ public:
+  explicit ArenaResource(std::size_t initialChunkSize = 64 * 1024,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  ArenaResource(const ArenaResource&) = delete;
+  ArenaResource(ArenaResource&&) = delete;
+  ~ArenaResource() override;
+
+  ArenaResource& operator=(const ArenaResource&) = delete;
+  ArenaResource& operator=(ArenaResource&&) = delete;
+
+  /// invalidates all allocations
+  void Reset();
+  /// invalidates all allocations and returns all memory to upstream
+  void Release();
+
+  /// bytes handed out since the last Reset(), including alignment padding
+  [[nodiscard]] std::size_t Used() const;
+  /// bytes currently taken from upstream
+  [[nodiscard]] std::size_t Capacity() const { return _capacity; }
+
+ private:
+  struct Chunk {
+    char* data;
+    std::size_t size;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  // continues in the next chunk that fits bytes, taking a new one from upstream if none does
+  void NextChunk(std::size_t bytes, std::size_t alignment);
+
+  std::pmr::memory_resource* _upstream;
+  std::size_t _initialChunkSize;
+  std::vector<Chunk> _chunks;
+  std::size_t _current = 0;  // index of the chunk allocated from
+  std::size_t _usedBefore = 0;  // bytes used in the chunks before the current one
+  char* _ptr = nullptr;
+  char* _end = nullptr;
+  std::size_t _capacity = 0;
+};
+
+/**
+ * PoolResource: size-class allocator. Blocks of up to MAX_BLOCK_SIZE bytes are rounded up to a power of two and
+ *  recycled through a free list per size class; larger blocks are only reclaimed by Reset(). All blocks are carved
+ *  from an ArenaResource, so Reset() is as cheap as for the arena.
+ *
+ * Not thread-safe.
+ */
+class PoolResource : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t MIN_BLOCK_SIZE = 16;
+  static constexpr std::size_t MAX_BLOCK_SIZE = 4096;
+
+  explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  PoolResource(const PoolResource&) = delete;
+  PoolResource(PoolResource&&) = delete;
+  ~PoolResource() override = default;
+
+  PoolResource& operator=(const PoolResource&) = delete;
+  PoolResource& operator=(PoolResource&&) = delete;
+
+  /// invalidates all allocations
+  void Reset();
+  /// invalidates all allocations and returns all memory to upstream
+  void Release();
+
+ private:
+  static constexpr std::size_t CLASSES = 9;  // 16 B .. 4 KiB
+  // blocks carved from the arena at once when a free list is empty
+  static constexpr std::size_t REFILL_BYTES = 16 * 1024;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  // index of the smallest size class holding bytes with the given alignment, CLASSES if there is none
+  static std::size_t SizeClass(std::size_t bytes, std::size_t alignment);
+
+  ArenaResource _arena;
+  std::array<FreeBlock*, CLASSES> _free{};
+};
+
+// memory resource provided to an AllocatorFixture
+enum class Allocator {
+  Malloc,
+  Arena,
+  Pool
+};
+
+const char* ToString(Allocator allocator);
+
+/**
+ * AllocatorFixture: fixture providing _memoryResource for the containers under test. The resource is reset after
+ *  every Reset() of the iteration, so containers using it must be destroyed or cleared in Reset() at the latest.
+ *
+ * With BENCHMARK_ALLOCATORS, the benchmark is registered once per Allocator and the results are compared side by
+ *  side; with any other benchmark macro, _memoryResource is the default (malloc backed) resource.
+ */
+class AllocatorFixture : public virtual Fixture {
+  friend class Benchmark;
+  friend class AsyncBenchmark;
+
+ public:
+  void SetAllocator(Allocator allocator);
+  [[nodiscard]] Allocator GetAllocator() const { return _allocator; }
+
+ protected:
+  std::pmr::memory_resource* _memoryResource = std::pmr::new_delete_resource();
+
+ private:
+  // called by the benchmark after Reset()
+  void ResetMemory();
+
+  Allocator _allocator = Allocator::Malloc;
+  ArenaResource _arena;
+  PoolResource _pool;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_MEMORY_H_
@@ -0,0 +1,127 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "benchmarked/fixture.h"
+
+#ifndef BENCHMARKED_PIPELINE_H_
+#define BENCHMARKED_PIPELINE_H_
+
+namespace benchmarked {
+
+/**
+ * InputPipeline: prepares the inputs of upcoming iterations on a producer thread while the current iteration is
+ *  measured. Benchmark::Launch() drives it for fixtures derived from PipelinedFixture.
+ *
+ * The measuring thread is pinned to the core it runs on and the producer to all other allowed cores, so preparing
+ *  inputs does not compete with the measured code for its core (but it may still compete for shared caches and
+ *  memory bandwidth). At most depth inputs are prepared ahead.
+ */
+class InputPipeline {
+  friend class Benchmark;
+
+ public:
+  InputPipeline() = default;
+  InputPipeline(const InputPipeline&) = delete;
+  InputPipeline(InputPipeline&&) = delete;
+  virtual ~InputPipeline();
+
+  InputPipeline& operator=(const InputPipeline&) = delete;
+  InputPipeline& operator=(InputPipeline&&) = delete;
+
+ protected:
+  // called on the producer thread: prepare one input and hand it over with Push()
+  virtual void Produce() = 0;
+  // called on the measuring thread with the lock held: make the oldest prepared input the current one
+  virtual void Consume() = 0;
+  // drop all prepared and the current input
+  virtual void Clear() = 0;
+  // called by Produce() after it appended an input under _pipelineMutex
+  void Pushed();
+
+  std::mutex _pipelineMutex;
+
+ private:
+  void StartPipeline(std::size_t depth, uint64_t inputs);
+  // blocks until the next input is ready, rethrows exceptions of the producer
+  void NextInput();
+  void StopPipeline();
+  void Join();
+  void ProducerLoop(uint64_t inputs);
+
+  std::condition_variable _pipelineCondVar;
+  std::size_t _depth = 0;
+  std::size_t _ready = 0;
+  bool _stop = false;
+  std::exception_ptr _error;
+  std::thread _producer;
+#if defined(__linux__)
+  bool _pinned = false;
+  cpu_set_t _previousAffinity{};
+#endif
+};
+
+/**
+ * PipelinedFixture: fixture whose per-iteration input is created by Prepare() on a producer thread, ahead of the
+ *  iteration using it (see InputPipeline). This cuts the total time of benchmarks whose input preparation is
+ *  expensive without changing what is measured: Run() finds the input ready in CurrentInput().
+ * \code{.cpp}
+ * class ShuffledKeys : public benchmarked::PipelinedFixture<std::vector<int>> {
+ *  protected:
+ *   std::vector<int> Prepare() override { return shuffled(100'000'000); }
+ * };
+ * BENCHMARK_FIXTURE(ShuffledKeys, "sort", "type", "description", 10) {
+ *   std::sort(CurrentInput().begin(), CurrentInput().end());
+ * }
+ * \endcode
+ * Prepare() must not touch other state of the fixture that Run() uses. Not used in open-loop mode.
+ */
+template<typename Input>
+class PipelinedFixture : public virtual Fixture, public InputPipeline {
+ protected:
+  // called on the producer thread once per iteration
+  virtual Input Prepare() = 0;
+
+  // input of the running iteration, valid from Initialize() to Reset()
+  Input& CurrentInput() { return *_current; }
+
+ private:
+  void Produce() override {
+    Input input = Prepare();
+    {
+      std::unique_lock locker(_pipelineMutex);
+      _prepared.push_back(std::move(input));
+    }
+    Pushed();
+  }
+
+  void Consume() override {
+    _current.emplace(std::move(_prepared.front()));
+    _prepared.pop_front();
+  }
+
+  void Clear() override {
+    _prepared.clear();
+    _current.reset();
+  }
+
+  std::deque<Input> _prepared;
+  std::optional<Input> _current;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_PIPELINE_H_
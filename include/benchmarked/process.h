@@ -0,0 +1,45 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "benchmarked/benchmark_base.h"
+
+#ifndef BENCHMARKED_PROCESS_H_
+#define BENCHMARKED_PROCESS_H_
+
+namespace benchmarked {
+
+/**
+ * ProcessBenchmark: runs an external command once per iteration and measures it from posix_spawn() until wait4()
+ *  returns, i.e. including process startup and teardown. The cpu time of a result is the user plus system time of
+ *  the child; both parts and the peak resident set size of every run are reported separately.
+ *
+ * The command is looked up in $PATH and inherits the environment. A command exiting with a non-zero status fails
+ *  the benchmark. See BenchmarkOptions::processWarmup, processPrepare and processOutput.
+ */
+class ProcessBenchmark : public BenchmarkBase {
+ public:
+  ProcessBenchmark(std::vector<std::string> command, const std::string &name, const std::string &type = "",
+                   const std::string &description = "", uint64_t iterations = 1, BenchmarkOptions options = {});
+  ProcessBenchmark(const ProcessBenchmark &) = delete;
+  ProcessBenchmark(ProcessBenchmark &&) = delete;
+  ~ProcessBenchmark() override = default;
+  ProcessBenchmark &operator=(const ProcessBenchmark &) = delete;
+  ProcessBenchmark &operator=(ProcessBenchmark &&) = delete;
+
+  void Launch() override;
+
+ private:
+  // spawns argv and waits for it, throws if it can not be started or does not exit with status 0
+  static ProcessRun Spawn(const std::vector<std::string> &argv, bool output, int64_t &wall_ns);
+
+  std::vector<std::string> _command;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_PROCESS_H_
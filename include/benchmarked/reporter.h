@@ -4,8 +4,14 @@
 #pragma once
 
 #include <iostream>
+#include <map>
+#include <optional>
+#include <string>
 
 #include "benchmarked/benchmark_base.h"
+#include "benchmarked/environment.h"
+#include "benchmarked/history.h"
+#include "benchmarked/statistics.h"
 
 #ifndef BENCHMARKED_REPORTER_H_
 #define BENCHMARKED_REPORTER_H_
@@ -29,20 +35,80 @@ class ConsoleReporter : public Reporter {
   void ReportInit(const std::string& launcherName) override;
   void ReportBenchmark(BenchmarkBase *benchmark) override;
 
+  // report this environment instead of the one of this process, e.g. the one of the merged checkpoints
+  void SetRecordedEnvironment(RecordedEnvironment recorded) { _recorded = std::move(recorded); }
+
  private:
+  // dispersion, confidence intervals, outliers and shape warnings of one time kind
+  void ReportSummary(const statistics::Summary& summary);
+  // median timings of the default results and all variants side by side
+  void ReportVariants(BenchmarkBase *benchmark);
+  // throughput and latency percentiles of the single operations of an async benchmark
+  void ReportLatencies(BenchmarkBase *benchmark);
+  // latency percentiles per offered load of an open-loop benchmark
+  void ReportLoadCurve(BenchmarkBase *benchmark);
+  // user/system cpu time split and peak memory of the runs of a process benchmark
+  void ReportProcessRuns(BenchmarkBase *benchmark);
+  // throughput and latency percentiles per role of a role benchmark
+  void ReportRoles(BenchmarkBase *benchmark);
+  // how far apart the threads of the iterations of a multi-threaded benchmark were released
+  void ReportStartSkew(BenchmarkBase *benchmark);
+  // logical and device I/O throughput of the iterations (BenchmarkOptions::ioAccounting)
+  void ReportIO(BenchmarkBase *benchmark);
+
   std::ostream& _stream;
+  std::optional<RecordedEnvironment> _recorded;
 };
 
+/**
+ * CSVReporter: one row per result set, so the report can be read by any CSV parser. The environment and the host
+ *  profile are written as "kind,name,value" rows to a separate metadata stream if one is given.
+ */
 class CSVReporter : public Reporter {
  public:
-  explicit CSVReporter(std::ostream& stream, const std::string& separator = ",") : _stream(stream), _separator(separator) {}
+  // values of the columns appended after the statistics columns, by column name
+  using Columns = std::map<std::string, std::string>;
+
+  explicit CSVReporter(std::ostream& stream, const std::string& separator = ",", std::ostream* metadata = nullptr)
+    : _stream(stream), _separator(separator), _metadata(metadata) {}
 
   void ReportInit(const std::string& launcherName) override;
   void ReportBenchmark(BenchmarkBase *benchmark) override;
 
+  // write this environment to the metadata stream instead of the one of this process
+  void SetRecordedEnvironment(RecordedEnvironment recorded) { _recorded = std::move(recorded); }
+
  private:
+  // one row per result set: variants are reported as "<name> [<label>]"
+  void ReportResults(BenchmarkBase *benchmark, const std::string& name, const std::vector<Result>& results,
+                     const Columns& columns = {});
+  // statistics columns are left empty for empty time vectors, appended columns missing in columns as well
+  void ReportRow(const std::string& name, const std::string& description, uint64_t iterations,
+                 const std::vector<uint64_t>& cpuTimes_ns, const std::vector<uint64_t>& wallTimes_ns,
+                 const Columns& columns = {});
+
+  // value quoted if it contains the separator, a quote or a line break
+  [[nodiscard]] std::string Quote(const std::string& value) const;
+
   std::ostream& _stream;
   std::string _separator;
+  std::ostream* _metadata;
+  std::optional<RecordedEnvironment> _recorded;
+};
+
+/**
+ * HistoryReporter: appends a summary of every benchmark to a HistoryStore.
+ */
+class HistoryReporter : public Reporter {
+ public:
+  explicit HistoryReporter(const std::string& path) : _store(path) {}
+
+  void ReportInit(const std::string& launcherName) override;
+  void ReportBenchmark(BenchmarkBase *benchmark) override;
+
+ private:
+  HistoryStore _store;
+  int64_t _timestamp = 0;
 };
 
 class CompareReporter {
@@ -0,0 +1,70 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "benchmarked/benchmark_base.h"
+#include "benchmarked/fixture.h"
+
+#ifndef BENCHMARKED_ROLES_H_
+#define BENCHMARKED_ROLES_H_
+
+namespace benchmarked {
+
+/**
+ * Role: threads running the same operation concurrently to the threads of other roles. The body is called once per
+ *  operation with the index of the thread within the role.
+ */
+struct Role {
+  std::string name;
+  unsigned threads = 1;
+  std::function<void(unsigned)> body;
+  // operations shared by the threads of the role per iteration, 0 = until the iteration ends
+  uint64_t operations = 0;
+};
+
+/**
+ * RoleBenchmark: benchmark of asymmetric thread roles, e.g. readers and writers of a shared data structure. Every
+ *  iteration starts the threads of all roles together and stops them at a shared deadline
+ *  (BenchmarkOptions::roleDuration) or once all roles with an operation limit have completed it. The latency of
+ *  every operation is recorded, throughput and latency are reported per role.
+ *
+ * Role bodies run concurrently and must be thread-safe with respect to each other.
+ */
+class RoleBenchmark : public BenchmarkBase, public virtual Fixture {
+ public:
+  explicit RoleBenchmark(const std::string &name,
+                         const std::string &type = "",
+                         const std::string &description = "",
+                         uint64_t iterations = 1,
+                         BenchmarkOptions options = {},
+                         std::function<void()> cleanUp = []() {}) : BenchmarkBase(name, type, description,
+                                                                                  iterations, std::move(cleanUp),
+                                                                                  std::move(options)) {}
+  RoleBenchmark(const RoleBenchmark &) = delete;
+  RoleBenchmark(RoleBenchmark &&) = delete;
+  ~RoleBenchmark() override = default;
+  RoleBenchmark &operator=(const RoleBenchmark &) = delete;
+  RoleBenchmark &operator=(RoleBenchmark &&) = delete;
+
+ protected:
+  // declares the roles with AddRole(), called once after SetUp()
+  virtual void DeclareRoles() = 0;
+  void AddRole(const std::string &name, unsigned threads, std::function<void(unsigned)> body,
+               uint64_t operations = 0);
+
+ private:
+  void Launch() override;
+  // runs the threads of all roles once, the cpu time of the result is the one of the whole process
+  Result LaunchRound();
+
+  std::vector<Role> _roles;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_ROLES_H_
@@ -0,0 +1,98 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#ifndef BENCHMARKED_STATISTICS_H_
+#define BENCHMARKED_STATISTICS_H_
+
+namespace benchmarked::statistics {
+
+// how the confidence interval of an Estimate was computed
+enum class IntervalMethod {
+  None,
+  ExactBootstrap,
+  PercentileBootstrap,
+  NormalApproximation
+};
+
+/// "exact bootstrap", "percentile bootstrap", "normal approximation" or "" for IntervalMethod::None
+const char* ToString(IntervalMethod method);
+
+/**
+ * Point estimate with a confidence interval.
+ */
+struct Estimate {
+  double value = 0;
+  double low = 0;
+  double high = 0;
+  double confidence = 0;
+  IntervalMethod method = IntervalMethod::None;
+};
+
+/**
+ * Summary: descriptive statistics of the samples of one benchmark, in the order they were measured.
+ *
+ * Outliers are classified with Tukey fences: mild outside [q1 - 1.5 IQR, q3 + 1.5 IQR], severe outside
+ *  [q1 - 3 IQR, q3 + 3 IQR]. The number of modes is counted on a gaussian kernel density estimate; together with the
+ *  bimodality coefficient (> 5/9 hints at more than one mode) it detects e.g. samples split by frequency scaling.
+ */
+struct Summary {
+  std::size_t count = 0;
+  double min = 0;
+  double max = 0;
+  double mean = 0;
+  double median = 0;
+  double stddev = 0;
+  // min and max are reported without a confidence interval
+  // median of the absolute deviations from the median in percent of the median
+  double medianAbsolutePercentError = 0;
+  Estimate meanCI;
+  Estimate medianCI;
+
+  double q1 = 0;
+  double q3 = 0;
+  std::size_t lowSevere = 0;
+  std::size_t lowMild = 0;
+  std::size_t highMild = 0;
+  std::size_t highSevere = 0;
+
+  double skewness = 0;
+  // excess kurtosis, 0 for a normal distribution
+  double kurtosis = 0;
+  double bimodalityCoefficient = 0;
+  unsigned modes = 0;
+  // lag-1 autocorrelation of consecutive samples, close to 0 for independent iterations
+  double autocorrelation = 0;
+
+  [[nodiscard]] std::size_t Outliers() const { return lowSevere + lowMild + highMild + highSevere; }
+  [[nodiscard]] bool Multimodal() const { return modes > 1; }
+};
+
+/**
+ * Computes the Summary of samples. The confidence interval of the median is the exact bootstrap distribution of the
+ *  sample median (no resampling needed), the one of the mean a percentile bootstrap with the given number of resamples.
+ *  For large sample counts, where the bootstrap would cost more than ~2^25 draws, the normal approximation it
+ *  converges to is used for the mean instead.
+ */
+Summary Summarize(const std::vector<double>& samples, double confidence = 0.95, unsigned resamples = 2000);
+
+/// p-th percentile (0 <= p <= 100) of values, linearly interpolated between the closest ranks
+double Percentile(std::vector<double> values, double p);
+
+/// same as Percentile() but values must already be sorted ascending
+double PercentileSorted(const std::vector<double>& sorted, double p);
+
+/**
+ * Ratio b/a of paired samples (a[i] and b[i] measured together) as geometric mean of the per-pair ratios, with a
+ *  percentile bootstrap confidence interval resampling whole pairs.
+ */
+Estimate BootstrapPairedRatio(const std::vector<double>& a, const std::vector<double>& b, double confidence = 0.95,
+                              unsigned resamples = 2000);
+
+}  // namespace benchmarked::statistics
+
+#endif //BENCHMARKED_STATISTICS_H_
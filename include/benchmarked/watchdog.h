@@ -0,0 +1,81 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#ifndef BENCHMARKED_WATCHDOG_H_
+#define BENCHMARKED_WATCHDOG_H_
+
+namespace benchmarked {
+
+/**
+ * Watchdog: calls onExpired from a background thread if it is not disarmed before the armed deadline. The thread is
+ *  started on the first Arm() call. onExpired is called with the lock of the watchdog held: Arm() and Disarm() block
+ *  until it returns, so the expired code can not get past its Disarm() while the expiry is handled.
+ *
+ * Thread-safe.
+ */
+class Watchdog {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit Watchdog(std::function<void()> onExpired);
+  Watchdog(const Watchdog&) = delete;
+  Watchdog(Watchdog&&) = delete;
+  ~Watchdog();
+
+  Watchdog& operator=(const Watchdog&) = delete;
+  Watchdog& operator=(Watchdog&&) = delete;
+
+  // returns the generation of this arm, which is replaced by the next Arm() call
+  uint64_t Arm(Clock::time_point deadline);
+  // disarms the watchdog if it is still armed with generation
+  void Disarm(uint64_t generation);
+
+ private:
+  void Loop();
+
+  std::function<void()> _onExpired;
+  std::mutex _mutex;
+  std::condition_variable _condVar;
+  Clock::time_point _deadline = Clock::time_point::max();
+  uint64_t _generation = 0;
+  bool _stop = false;
+  std::thread _thread;
+};
+
+/**
+ * WatchdogArm: arms a watchdog until it is destroyed or Disarm() is called, also if the armed code throws.
+ */
+class WatchdogArm {
+ public:
+  WatchdogArm() = default;
+  WatchdogArm(Watchdog &watchdog, Watchdog::Clock::time_point deadline)
+    : _watchdog(&watchdog), _generation(watchdog.Arm(deadline)) {}
+  WatchdogArm(const WatchdogArm&) = delete;
+  WatchdogArm(WatchdogArm&&) = delete;
+  ~WatchdogArm() { Disarm(); }
+
+  WatchdogArm& operator=(const WatchdogArm&) = delete;
+  WatchdogArm& operator=(WatchdogArm&&) = delete;
+
+  void Disarm() {
+    if (_watchdog != nullptr) { _watchdog->Disarm(_generation); }
+    _watchdog = nullptr;
+  }
+
+ private:
+  Watchdog *_watchdog = nullptr;
+  uint64_t _generation = 0;
+};
+
+}  // namespace benchmarked
+
+#endif //BENCHMARKED_WATCHDOG_H_
@@ -0,0 +1,131 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <thread>
+
+#include "benchmarked/async.h"
+#include "benchmarked/memory.h"
+#include "timed/Timer.h"
+
+namespace benchmarked {
+
+static thread_local Executor* currentExecutor = nullptr;
+
+// ===== Executor ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Executor* Executor::Current() {
+  return currentExecutor;
+}
+
+// _____________________________________________________________________________________________________________________
+void Executor::SetCurrent(Executor* executor) {
+  currentExecutor = executor;
+}
+
+// ===== EventLoop =====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void EventLoop::Post(std::coroutine_handle<> handle) {
+  _ready.push_back(handle);
+}
+
+// _____________________________________________________________________________________________________________________
+void EventLoop::PostAt(std::chrono::steady_clock::time_point time, std::coroutine_handle<> handle) {
+  _timers.push({time, _sequence++, handle});
+}
+
+// _____________________________________________________________________________________________________________________
+void EventLoop::Run() {
+  while (!_ready.empty() || !_timers.empty()) {
+    auto now = std::chrono::steady_clock::now();
+    while (!_timers.empty() && _timers.top().time <= now) {
+      _ready.push_back(_timers.top().handle);
+      _timers.pop();
+    }
+    if (_ready.empty()) {
+      std::this_thread::sleep_until(_timers.top().time);
+      continue;
+    }
+    auto handle = _ready.front();
+    _ready.pop_front();
+    handle.resume();
+  }
+}
+
+// ===== AsyncBenchmark ================================================================================================
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void AsyncBenchmark::Launch() {
+  EventLoop eventLoop;
+  Executor* executor = _options.executor ? _options.executor.get() : &eventLoop;
+  Executor* previous = Executor::Current();
+  Executor::SetCurrent(executor);
+
+  timed::WallTimer wall_timer;
+  timed::CPUTimer cpu_timer;
+  auto *allocatorFixture = dynamic_cast<AllocatorFixture *>(this);
+
+  SetUp();
+
+  uint64_t operations = _options.asyncOperations;
+  uint64_t concurrency = std::max<uint64_t>(std::min(_options.asyncConcurrency, operations), 1);
+  for (uint64_t iteration = 0; iteration < _iterations && !DeadlineReached(); ++iteration) {
+    Initialize();
+
+    _cleanUp();
+
+    std::vector<uint64_t> latencies_ns(operations);
+    uint64_t next = 0;
+    std::vector<Task> lanes;
+    lanes.reserve(concurrency);
+    for (uint64_t lane = 0; lane < concurrency; ++lane) {
+      lanes.push_back(Lane(next, operations, latencies_ns));
+    }
+
+    auto armed = ArmWatchdog();
+    wall_timer.start();
+    cpu_timer.start();
+
+    for (auto &lane: lanes) {
+      executor->Post(lane.Handle());
+    }
+    executor->Run();
+
+    cpu_timer.stop();
+    wall_timer.stop();
+    armed.Disarm();
+
+    for (auto &lane: lanes) {
+      if (lane.Handle().promise().exception) {
+        Executor::SetCurrent(previous);
+        std::rethrow_exception(lane.Handle().promise().exception);
+      }
+    }
+
+    Record([&]() {
+      _results.emplace_back(cpu_timer.getTime(), wall_timer.getTime());
+      _latencies_ns.insert(_latencies_ns.end(), latencies_ns.begin(), latencies_ns.end());
+    });
+
+    Reset();
+    if (allocatorFixture != nullptr) { allocatorFixture->ResetMemory(); }
+  }
+
+  CleanUp();
+  Executor::SetCurrent(previous);
+  _launched = true;
+}
+
+// _____________________________________________________________________________________________________________________
+Task AsyncBenchmark::Lane(uint64_t &next, uint64_t operations, std::vector<uint64_t> &latencies_ns) {
+  while (next < operations) {
+    uint64_t operation = next++;
+    auto start = std::chrono::steady_clock::now();
+    co_await Run();
+    auto end = std::chrono::steady_clock::now();
+    latencies_ns[operation] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  }
+}
+
+}  // namespace benchmarked
@@ -1,37 +1,103 @@
 // Copyright Leon Freist
 // Author Leon Freist <freist@informatik.uni-freiburg.de>
 
-#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "benchmarked/barrier.h"
 
 namespace benchmarked {
 
+namespace {
+
+// _____________________________________________________________________________________________________________________
+int64_t Now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// _____________________________________________________________________________________________________________________
+inline void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+}  // namespace
+
 // ===== Barrier =======================================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-Barrier::Barrier(unsigned threads) noexcept {
-  if (threads == 0) { std::runtime_error("Barrier threads counter must not be zero (0)."); }
-  _counter = threads;
-  _threads = threads;
+Barrier::Barrier(unsigned threads, std::chrono::nanoseconds spinTime)
+    : _threads(threads),
+      // spinning threads would keep the ones still to arrive from running if there are not enough cores for all
+      _spinTime(threads <= std::max(std::thread::hardware_concurrency(), 1u) ? spinTime : std::chrono::nanoseconds(0)) {
+  if (threads == 0) { throw std::invalid_argument("Barrier threads counter must not be zero (0)."); }
 }
 
 // _____________________________________________________________________________________________________________________
 bool Barrier::Wait() noexcept {
-  std::unique_lock<std::mutex> lock(_mutex);
+  uint32_t generation = _generation.load(std::memory_order_acquire);
 
-  int generation = _generation;
-
-  if (--_counter == 0) {
-    _generation++;
-    _counter = _threads;
-    _condVar.notify_all();
+  if (_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == _threads) {
+    // all threads of this generation have left the previous one, so nobody updates the skew anymore
+    _arrived.store(0, std::memory_order_relaxed);
+    _skew_ns.store(0, std::memory_order_relaxed);
+    _release_ns.store(Now_ns(), std::memory_order_relaxed);
+    _generation.store(generation + 1, std::memory_order_seq_cst);
+    if (_parked.load(std::memory_order_seq_cst) > 0) { WakeAll(); }
     return true;
   }
 
-  _condVar.wait(lock, [&, this]() { return generation != _generation; });
+  auto spinEnd = Now_ns() + _spinTime.count();
+  for (unsigned i = 1; _generation.load(std::memory_order_acquire) == generation; ++i) {
+    Pause();
+    // reading the clock is more expensive than a pause, check it only now and then
+    if (i % 64 == 0 && Now_ns() > spinEnd) {
+      Park(generation);
+      break;
+    }
+  }
 
+  int64_t delay = Now_ns() - _release_ns.load(std::memory_order_relaxed);
+  int64_t skew = _skew_ns.load(std::memory_order_relaxed);
+  while (delay > skew && !_skew_ns.compare_exchange_weak(skew, delay, std::memory_order_relaxed)) {}
   return false;
 }
 
-}  // namespace benchmarked
\ No newline at end of file
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void Barrier::Park(uint32_t generation) noexcept {
+  // together with the seq_cst store and load of the last thread, either that thread sees this one parked or this one
+  //  sees the new generation (and the futex returns immediately)
+  _parked.fetch_add(1, std::memory_order_seq_cst);
+  while (_generation.load(std::memory_order_seq_cst) == generation) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_generation), FUTEX_WAIT_PRIVATE, generation, nullptr, nullptr,
+            0);
+#else
+    _generation.wait(generation, std::memory_order_acquire);
+#endif
+  }
+  _parked.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// _____________________________________________________________________________________________________________________
+void Barrier::WakeAll() noexcept {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_generation), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+  _generation.notify_all();
+#endif
+}
+
+}  // namespace benchmarked
@@ -3,254 +3,387 @@
 
 #include <iostream>
 #include <sstream>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <ctime>
+#include <stdexcept>
+#include <exception>
 
 #include "benchmarked/benchmark.h"
 #include "timed/Timer.h"
 
 namespace benchmarked {
 
+namespace {
+
+/**
+ * ThreadExitCallbacks: callbacks registered by AtThreadExit() on one thread, run when the thread exits.
+ */
+struct ThreadExitCallbacks {
+  ~ThreadExitCallbacks() {
+    for (auto &callback: callbacks) { callback(); }
+  }
+
+  std::vector<std::function<void()>> callbacks;
+};
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+void AtThreadExit(std::function<void()> callback) {
+  thread_local ThreadExitCallbacks threadExitCallbacks;
+  threadExitCallbacks.callbacks.push_back(std::move(callback));
+}
+
 // ===== Benchmark =====================================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
 void Benchmark::Launch() {
+  _allocatorFixture = dynamic_cast<AllocatorFixture *>(this);
+  if (_options.openLoopRate > 0) {
+    LaunchOpenLoop();
+    return;
+  }
+
+  SetUp();
+
+  std::unique_ptr<CacheEvictor> evictor;
+  if (_options.coldCache) {
+    evictor = std::make_unique<CacheEvictor>(_options.remapColdCache);
+    _resultsLabel = "hot";
+    _variants.push_back({"cold", {}});
+  }
+
+  _pipeline = dynamic_cast<InputPipeline *>(this);
+  if (_pipeline != nullptr) {
+    _pipeline->StartPipeline(std::max<std::size_t>(_options.pipelineDepth, 1), _iterations * (evictor ? 2 : 1));
+  }
+
+  try {
+    for (uint64_t iteration = 0; iteration < _iterations && !DeadlineReached(); ++iteration) {
+      auto result = LaunchIteration(nullptr);
+      Record([&]() { _results.push_back(result); });
+      if (evictor) {
+        auto cold = LaunchIteration(evictor.get());
+        Record([&]() { _variants.back().results.push_back(cold); });
+      }
+    }
+  } catch (...) {
+    // the producer calls into this object, it must be stopped before the exception unwinds it
+    if (_pipeline != nullptr) { _pipeline->StopPipeline(); }
+    throw;
+  }
+
+  if (_pipeline != nullptr) { _pipeline->StopPipeline(); }
+  CleanUp();
+  _launched = true;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Result Benchmark::LaunchIteration(CacheEvictor *evictor) {
   timed::WallTimer wall_timer;
   timed::CPUTimer cpu_timer;
 
-  SetUp();
+  if (_pipeline != nullptr) { _pipeline->NextInput(); }
+  Initialize();
 
-  for (uint64_t iteration = 0; iteration < _iterations; ++iteration) {
-    Initialize();
+  _cleanUp();
 
-    _cleanUp();
+  if (evictor != nullptr) {
+    evictor->Evict();
+  }
 
-    wall_timer.start();
-    cpu_timer.start();
+  std::optional<IOCounters> ioBefore;
+  if (_options.ioAccounting && evictor == nullptr) {
+    IOCounters::ReadOverhead();
+    ioBefore = IOCounters::Read();
+  }
 
-    Run();
+  _pause = PauseState();
+  _pause.timing = true;
+  auto armed = ArmWatchdog();
 
-    cpu_timer.stop();
-    wall_timer.stop();
+  wall_timer.start();
+  cpu_timer.start();
 
-    _results.emplace_back(cpu_timer.getTime(), wall_timer.getTime());
+  Run();
 
-    Reset();
+  cpu_timer.stop();
+  wall_timer.stop();
+
+  if (ioBefore) {
+    if (auto ioAfter = IOCounters::Read()) {
+      Record([&]() { _io.push_back(*ioAfter - *ioBefore - IOCounters::ReadOverhead()); });
+    }
   }
 
-  CleanUp();
-  _launched = true;
+  armed.Disarm();
+  if (_pause.paused) { ResumeTiming(); }
+  _pause.timing = false;
+
+  Result result(cpu_timer.getTime(), wall_timer.getTime());
+  if (_pause.pauses > 0) {
+    if (!_pauseCalibrated) { CalibratePauseOverhead(); }
+    auto pauses = static_cast<double>(_pause.pauses);
+    auto measured_wall_ns = static_cast<double>(wall_timer.getTime().getNanoseconds());
+    auto measured_cpu_ns = static_cast<double>(cpu_timer.getTime().getNanoseconds());
+    double wall_ns = measured_wall_ns - static_cast<double>(_pause.paused_wall_ns) - pauses * _pauseOverhead_wall_ns;
+    double cpu_ns = measured_cpu_ns - _pause.paused_cpu_ns - pauses * _pauseOverhead_cpu_ns;
+    result = Result(timed::Time(std::chrono::nanoseconds(std::llround(std::max(cpu_ns, 0.0)))),
+                    timed::Time(std::chrono::nanoseconds(std::llround(std::max(wall_ns, 0.0)))));
+  }
+
+  Reset();
+  if (_allocatorFixture != nullptr) { _allocatorFixture->ResetMemory(); }
+
+  return result;
 }
 
-// ===== CodeBenchmarkThreadCPU ========================================================================================
-// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkThreadCPU::start() {
-  std::unique_lock locker(_pushToResultPairsMutex);
-  auto &res_vector = _resultPairs[std::this_thread::get_id()];
-  auto now = boost::chrono::thread_clock::now();
-  if (res_vector.empty()) {
-    res_vector.push_back({now, now});
-    return;
-  }
-  if (res_vector.back().second == res_vector.back().first) {
-    throw std::runtime_error(
-      "Starting dynamic benchmark failed, since there already is a timer running for this thread on this benchmark id"
-    );
-  } else {
-    res_vector.push_back({now, now});
+void Benchmark::CalibratePauseOverhead() {
+  constexpr unsigned PAIRS = 1000;
+  timed::WallTimer wall_timer;
+  timed::CPUTimer cpu_timer;
+  PauseState iterationState = _pause;
+
+  _pause = PauseState();
+  _pause.timing = true;
+  wall_timer.start();
+  cpu_timer.start();
+  for (unsigned i = 0; i < PAIRS; ++i) {
+    PauseTiming();
+    ResumeTiming();
   }
+  cpu_timer.stop();
+  wall_timer.stop();
+
+  auto measured_wall_ns = static_cast<double>(wall_timer.getTime().getNanoseconds());
+  auto measured_cpu_ns = static_cast<double>(cpu_timer.getTime().getNanoseconds());
+  double wall_ns = measured_wall_ns - static_cast<double>(_pause.paused_wall_ns);
+  double cpu_ns = measured_cpu_ns - _pause.paused_cpu_ns;
+  _pauseOverhead_wall_ns = std::max(wall_ns, 0.0) / PAIRS;
+  _pauseOverhead_cpu_ns = std::max(cpu_ns, 0.0) / PAIRS;
+  _pauseCalibrated = true;
+  _pause = iterationState;
 }
 
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkThreadCPU::stop() {
-  std::unique_lock locker(_pushToResultPairsMutex);
-  auto now = boost::chrono::thread_clock::now();
-  auto &res_vector = _resultPairs[std::this_thread::get_id()];
-  if (res_vector.empty()) { return; }
-  auto &pair = res_vector.back();
-  if (pair.second == pair.first) {
-    pair.second = now;
-  }
-  else {
-    throw std::runtime_error(
-      "Stopping code benchmark failed, since this benchmark id has not started a timer on this thread yet."
-    );
+void Benchmark::PauseTiming() {
+  if (!_pause.timing || _pause.paused) { return; }
+  _pause.paused = true;
+  _pause.pauses++;
+  // fresh timers for every pause, they are not restarted
+  _pause.cpuPause = timed::CPUTimer();
+  _pause.wallPause = timed::WallTimer();
+  _pause.cpuPause.start();
+  _pause.wallPause.start();
+}
+
+// _____________________________________________________________________________________________________________________
+void Benchmark::ResumeTiming() {
+  if (!_pause.timing || !_pause.paused) { return; }
+  _pause.wallPause.stop();
+  _pause.cpuPause.stop();
+  _pause.paused = false;
+  _pause.paused_wall_ns += static_cast<int64_t>(_pause.wallPause.getTime().getNanoseconds());
+  _pause.paused_cpu_ns += static_cast<double>(_pause.cpuPause.getTime().getNanoseconds());
+}
+
+// _____________________________________________________________________________________________________________________
+void Benchmark::LaunchOpenLoop() {
+  SetUp();
+
+  double rate = _options.openLoopRate;
+  for (unsigned step = 0; step < _options.openLoopMaxSteps && !DeadlineReached(); ++step) {
+    Initialize();
+    _cleanUp();
+    auto armed = ArmWatchdog();
+    auto point = LaunchOpenLoopStep(rate);
+    armed.Disarm();
+    Record([&]() { _loadCurve.push_back(std::move(point)); });
+    Reset();
+    if (_allocatorFixture != nullptr) { _allocatorFixture->ResetMemory(); }
+    if (_loadCurve.back().saturated) { break; }
+    rate *= _options.openLoopRateFactor;
   }
+
+  CleanUp();
+  _launched = true;
 }
 
 // _____________________________________________________________________________________________________________________
-std::map<std::thread::id, double> CodeBenchmarkThreadCPU::getResults() const {
-  std::map<std::thread::id, double> result;
-  for (const auto &[thread_id, intervals]: _resultPairs) {
-    // MARK: look up is O(log n) -> this reference might be super unnecessary...
-    auto& value = result[thread_id];
-    value = 0;
-    for (const auto &[start, end]: intervals) {
-      value += double((end - start).count());
+LoadPoint Benchmark::LaunchOpenLoopStep(double rate) {
+  using clock = std::chrono::steady_clock;
+
+  // intended start times are fixed before the first operation runs, so that a stalled operation delays the start
+  //  of all following operations and this delay is accounted to their latency (coordinated omission).
+  std::vector<clock::duration> schedule(_iterations);
+  std::mt19937_64 rng(_iterations);
+  std::exponential_distribution<double> interArrival(rate);
+  double offset_s = 0;
+  for (auto &intended: schedule) {
+    intended = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(offset_s));
+    offset_s += _options.arrival == Arrival::Poisson ? interArrival(rng) : 1.0 / rate;
+  }
+
+  LoadPoint point;
+  point.offeredRate = rate;
+  point.latencies_ns.resize(_iterations);
+
+  unsigned workers = std::max(_options.openLoopWorkers, 1u);
+  std::vector<clock::time_point> lastCompletion(workers);
+  std::atomic<uint64_t> next(0);
+  // the first exception thrown by Run() on any worker, rethrown once all workers are joined
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  // leave some time for the worker threads to start up before the first operation is due
+  auto start = clock::now() + std::chrono::milliseconds(1);
+
+  auto work = [&, this](unsigned worker) {
+    for (uint64_t i = next.fetch_add(1, std::memory_order_relaxed); i < _iterations;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      auto intended = start + schedule[i];
+      // sleep until shortly before the operation is due, spin for the rest to not depend on the wake-up latency
+      if (intended - clock::now() > std::chrono::microseconds(200)) {
+        std::this_thread::sleep_until(intended - std::chrono::microseconds(100));
+      }
+      while (clock::now() < intended) {}
+
+      try {
+        Run();
+      } catch (...) {
+        std::unique_lock lock(errorMutex);
+        if (!error) { error = std::current_exception(); }
+        // no further operations are started by any worker
+        next.store(_iterations, std::memory_order_relaxed);
+        return;
+      }
+
+      auto end = clock::now();
+      point.latencies_ns[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - intended).count();
+      lastCompletion[worker] = end;
     }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(work, worker);
   }
-  return result;
+  work(0);
+  for (auto &thread: threads) {
+    thread.join();
+  }
+  if (error) { std::rethrow_exception(error); }
+
+  auto end = *std::max_element(lastCompletion.begin(), lastCompletion.end());
+  double elapsed_s = std::chrono::duration<double>(end - start).count();
+  point.achievedRate = elapsed_s > 0 ? static_cast<double>(_iterations) / elapsed_s : 0;
+  // saturated: operations are completed slower than they are scheduled. The duration of the step is compared with
+  //  the schedule actually drawn (plus one mean inter-arrival time for the last operation), since random Poisson
+  //  arrivals alone often take more than 10% longer than _iterations / rate.
+  double scheduled_s = (_iterations > 0 ? std::chrono::duration<double>(schedule.back()).count() : 0) + 1.0 / rate;
+  point.saturated = elapsed_s > scheduled_s / 0.9;
+  return point;
 }
 
-// ===== CodeBenchmarkTotalCPU ========================================================================================
+// ===== CodeBenchmarkThreadCPU ========================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkTotalCPU::start() {
+void CodeBenchmarkThreadCPU::start(bool strict) {
   std::unique_lock locker(_pushToResultPairsMutex);
-  auto &res_vector = _resultPairs[std::thread::id(0)];
-  auto now = std::clock();
-  if (res_vector.empty()) {
-    res_vector.push_back({now, now});
-    return;
-  }
-  if (res_vector.back().second == res_vector.back().first) {
-    throw std::runtime_error(
-        "Starting dynamic benchmark failed, since there already is a timer running for this thread on this benchmark id"
-    );
-  } else {
-    res_vector.push_back({now, now});
-  }
+  Open(std::this_thread::get_id(), boost::chrono::thread_clock::now(), strict);
 }
 
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkTotalCPU::stop() {
+void CodeBenchmarkThreadCPU::stop(bool strict) {
+  auto now = boost::chrono::thread_clock::now();
   std::unique_lock locker(_pushToResultPairsMutex);
-  auto now = std::clock();
-  auto &res_vector = _resultPairs[std::thread::id(0)];
-  if (res_vector.empty()) { return; }
-  auto &pair = res_vector.back();
-  if (pair.second == pair.first) {
-    pair.second = now;
-  }
-  else {
-    throw std::runtime_error(
-        "Stopping code benchmark failed, since this benchmark id has not started a timer on this thread yet."
-    );
-  }
+  auto start = Close(std::this_thread::get_id(), strict);
+  if (!start) { return; }
+  Record(std::this_thread::get_id(), boost::chrono::duration_cast<boost::chrono::nanoseconds>(now - *start).count());
 }
 
+// ===== CodeBenchmarkTotalCPU ========================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-std::map<std::thread::id, double> CodeBenchmarkTotalCPU::getResults() const {
-  std::map<std::thread::id, double> result;
-  // only one single element with thread::id == 0 is available here...
-  for (const auto &[thread_id, intervals]: _resultPairs) {
-    // MARK: look up is O(log n) -> this reference might be super unnecessary...
-    auto& value = result[thread_id];
-    value = 0;
-    for (const auto &[start, end]: intervals) {
-      value += double((end - start)) / CLOCKS_PER_SEC;
-    }
-    value *= 1000 * 1000 * 1000;
-  }
-  return result;
+void CodeBenchmarkTotalCPU::start(bool strict) {
+  std::unique_lock locker(_pushToResultPairsMutex);
+  Open(std::thread::id(0), std::clock(), strict);
 }
 
-// ===== CodeBenchmarkThreadWall ========================================================================================
-// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkThreadWall::start() {
+void CodeBenchmarkTotalCPU::stop(bool strict) {
+  auto now = std::clock();
   std::unique_lock locker(_pushToResultPairsMutex);
-  auto &res_vector = _resultPairs[std::this_thread::get_id()];
-  auto now = std::chrono::steady_clock::now();
-  if (res_vector.empty()) {
-    res_vector.push_back({now, now});
-    return;
-  }
-  if (res_vector.back().second == res_vector.back().first) {
-    throw std::runtime_error(
-        "Starting dynamic benchmark failed, since there already is a timer running for this thread on this benchmark id"
-    );
-  } else {
-    res_vector.push_back({now, now});
-  }
+  auto start = Close(std::thread::id(0), strict);
+  if (!start) { return; }
+  Record(std::thread::id(0), static_cast<uint64_t>(double(now - *start) / CLOCKS_PER_SEC * 1000 * 1000 * 1000));
 }
 
+// ===== CodeBenchmarkThreadWall ========================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkThreadWall::stop() {
+void CodeBenchmarkThreadWall::start(bool strict) {
   std::unique_lock locker(_pushToResultPairsMutex);
-  auto now = std::chrono::steady_clock::now();
-  auto &res_vector = _resultPairs[std::this_thread::get_id()];
-  if (res_vector.empty()) { return; }
-  auto &pair = res_vector.back();
-  if (pair.second == pair.first) {
-    pair.second = now;
-  }
-  else {
-    throw std::runtime_error(
-        "Stopping code benchmark failed, since this benchmark id has not started a timer on this thread yet."
-    );
-  }
+  Open(std::this_thread::get_id(), std::chrono::steady_clock::now(), strict);
 }
 
 // _____________________________________________________________________________________________________________________
-std::map<std::thread::id, double> CodeBenchmarkThreadWall::getResults() const {
-  std::map<std::thread::id, double> result;
-  for (const auto &[thread_id, intervals]: _resultPairs) {
-    // MARK: look up is O(log n) -> this reference might be super unnecessary...
-    auto& value = result[thread_id];
-    value = 0;
-    for (const auto &[start, end]: intervals) {
-      value += double((end - start).count());
-    }
-  }
-  return result;
+void CodeBenchmarkThreadWall::stop(bool strict) {
+  auto now = std::chrono::steady_clock::now();
+  std::unique_lock locker(_pushToResultPairsMutex);
+  auto start = Close(std::this_thread::get_id(), strict);
+  if (!start) { return; }
+  Record(std::this_thread::get_id(), std::chrono::duration_cast<std::chrono::nanoseconds>(now - *start).count());
 }
 
 // ===== CodeBenchmarkWall ========================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkWall::start() {
+void CodeBenchmarkWall::start(bool strict) {
   std::unique_lock locker(_pushToResultPairsMutex);
-  auto &res_vector = _resultPairs[std::thread::id(0)];
-  auto now = std::chrono::steady_clock::now();
-  if (res_vector.empty()) {
-    res_vector.push_back({now, now});
-    return;
-  }
-  if (res_vector.back().second == res_vector.back().first) {
-    throw std::runtime_error(
-        "Starting dynamic benchmark failed, since there already is a timer running for this benchmark id"
-    );
-  } else {
-    res_vector.push_back({now, now});
-  }
+  Open(std::thread::id(0), std::chrono::steady_clock::now(), strict);
 }
 
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkWall::stop() {
+void CodeBenchmarkWall::stop(bool strict) {
+  auto now = std::chrono::steady_clock::now();
   std::unique_lock locker(_pushToResultPairsMutex);
+  auto start = Close(std::thread::id(0), strict);
+  if (!start) { return; }
+  Record(std::thread::id(0), std::chrono::duration_cast<std::chrono::nanoseconds>(now - *start).count());
+}
+
+// ===== Span ==========================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void Span::Stop() {
+  if (_site == nullptr) { return; }
   auto now = std::chrono::steady_clock::now();
-  auto &res_vector = _resultPairs[std::thread::id(0)];
-  if (res_vector.empty()) { return; }
-  auto &pair = res_vector.back();
-  if (pair.second == pair.first) {
-    pair.second = now;
-  }
-  else {
-    throw std::runtime_error(
-        "Stopping code benchmark failed, since this benchmark id has not started a timer on this thread yet."
-    );
-  }
+  uint64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _start).count();
+  _site->_histogram.Record(duration_ns);
+  if (auto eventId = _site->getEventId(); eventId != ring::kNoName) { EventRing::Get()->Publish(eventId, duration_ns); }
+  _site = nullptr;
 }
 
+// ===== SpanSite ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-std::map<std::thread::id, double> CodeBenchmarkWall::getResults() const {
-  std::map<std::thread::id, double> result;
-  // only one single element with thread::id == 0 is in this map...
-  for (const auto &[thread_id, intervals]: _resultPairs) {
-    // MARK: look up is O(log n) -> this reference might be super unnecessary...
-    auto& value = result[thread_id];
-    value = 0;
-    for (const auto &[start, end]: intervals) {
-      value += double((end - start).count());
-    }
-  }
-  return result;
+Span SpanSite::Start() {
+  _started.fetch_add(1, std::memory_order_relaxed);
+  return {this, std::chrono::steady_clock::now()};
 }
 
 // ===== CodeBenchmarkHandler ==========================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
 std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
+  std::shared_lock benchmarksLocker(_benchmarksMutex);
+  std::unique_lock spansLocker(_spansMutex);
   const std::string sep(",");
   if (fmt == "csv") {
     std::stringstream ss;
@@ -271,10 +404,17 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
       auto tmp_size = bm.getResults().size();
       max_size = tmp_size > max_size ? tmp_size : max_size;
     }
+    // the per thread totals are followed by the distribution of the single intervals of all threads
+    auto histogramColumns = [&ss, &sep](const LatencyHistogram &histogram) {
+      ss << sep << histogram.Count() << sep << std::llround(histogram.Mean()) << sep
+         << std::llround(histogram.Percentile(50)) << sep << std::llround(histogram.Percentile(99)) << sep
+         << histogram.Max();
+    };
     ss << "bm_type" << sep << "name";
     for (unsigned i = 0; i < max_size; ++i) {
       ss << sep << i;
     }
+    ss << sep << "calls" << sep << "mean [ns]" << sep << "p50 [ns]" << sep << "p99 [ns]" << sep << "max [ns]";
     ss << '\n';
     for (const auto &[name, bm]: _threadCPU_benchmarks) {
       ss << "thread CPU [ns]" << sep << name;
@@ -286,6 +426,7 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
       for (;nums > 0; --nums) {
         ss << sep;
       }
+      histogramColumns(bm.getHistogram());
       ss << '\n';
     }
     for (const auto &[name, bm]: _totalCPU_benchmarks) {
@@ -298,6 +439,7 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
       for (;nums > 0; --nums) {
         ss << sep;
       }
+      histogramColumns(bm.getHistogram());
       ss << '\n';
     }
     for (const auto &[name, bm]: _threadWall_benchmarks) {
@@ -310,6 +452,7 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
       for (;nums > 0; --nums) {
         ss << sep;
       }
+      histogramColumns(bm.getHistogram());
       ss << '\n';
     }
     for (const auto &[name, bm]: _wall_benchmarks) {
@@ -322,6 +465,15 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
       for (;nums > 0; --nums) {
         ss << sep;
       }
+      histogramColumns(bm.getHistogram());
+      ss << '\n';
+    }
+    for (const auto &[name, site]: _spans) {
+      ss << "span Wall [ns]" << sep << name;
+      for (unsigned nums = max_size; nums > 0; --nums) {
+        ss << sep;
+      }
+      histogramColumns(site.getHistogram());
       ss << '\n';
     }
     return ss.str();
@@ -344,6 +496,18 @@ std::string CodeBenchmarkHandler::Report(const std::string &fmt) const {
     for (const auto &[name, bm]: _wall_benchmarks) {
       ss << name << " - " << bm << std::endl;
     }
+    ss << "Spans:\n";
+    for (const auto &[name, site]: _spans) {
+      auto histogram = site.getHistogram();
+      ss << name << " - " << histogram.Sum() / 1000.0 / 1000.0 << " ms\n"
+         << "  calls: " << histogram.Count() << ", mean: " << histogram.Mean() / 1000.0 << " us, p50: "
+         << histogram.Percentile(50) / 1000.0 << " us, p99: " << histogram.Percentile(99) / 1000.0 << " us, max: "
+         << static_cast<double>(histogram.Max()) / 1000.0 << " us";
+      if (auto open = site.getOpen(); open > 0) {
+        ss << ", still open: " << open;
+      }
+      ss << "\n" << std::endl;
+    }
     return ss.str();
   }
 }
@@ -355,25 +519,99 @@ CodeBenchmarkHandler &CodeBenchmarkHandler::GetInstance() {
 }
 
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkHandler::start(const std::string &name, uint8_t bm_t_id) {
+std::vector<ScopeSnapshot> CodeBenchmarkHandler::Snapshot() const {
+  std::vector<ScopeSnapshot> snapshots;
+  {
+    std::shared_lock locker(_benchmarksMutex);
+    for (const auto &[name, bm]: _threadCPU_benchmarks) {
+      snapshots.push_back({name, "thread_cpu", bm.getHistogram()});
+    }
+    for (const auto &[name, bm]: _totalCPU_benchmarks) {
+      snapshots.push_back({name, "total_cpu", bm.getHistogram()});
+    }
+    for (const auto &[name, bm]: _threadWall_benchmarks) {
+      snapshots.push_back({name, "thread_wall", bm.getHistogram()});
+    }
+    for (const auto &[name, bm]: _wall_benchmarks) {
+      snapshots.push_back({name, "wall", bm.getHistogram()});
+    }
+  }
+  std::unique_lock locker(_spansMutex);
+  for (const auto &[name, site]: _spans) { snapshots.push_back({name, "span", site.getHistogram()}); }
+  return snapshots;
+}
+
+// _____________________________________________________________________________________________________________________
+SpanSite &CodeBenchmarkHandler::span(const std::string &name) {
+  std::unique_lock locker(_spansMutex);
+  auto [it, inserted] = _spans.try_emplace(name);
+  if (inserted && EventRing::Get() != nullptr) {
+    it->second.setEventId(EventRing::Get()->NameId("span", name));
+  }
+  return it->second;
+}
+
+// _____________________________________________________________________________________________________________________
+void CodeBenchmarkHandler::start(const std::string &name, uint8_t bm_t_id, bool strict) {
   switch (bm_t_id) {
-    case 0: _threadCPU_benchmarks[name].start(); break;
-    case 1: _totalCPU_benchmarks[name].start(); break;
-    case 2: _threadWall_benchmarks[name].start(); break;
-    case 3: _wall_benchmarks[name].start(); break;
+    case 0: Lookup(_threadCPU_benchmarks, name, "thread_cpu").start(strict); break;
+    case 1: Lookup(_totalCPU_benchmarks, name, "total_cpu").start(strict); break;
+    case 2: Lookup(_threadWall_benchmarks, name, "thread_wall").start(strict); break;
+    case 3: Lookup(_wall_benchmarks, name, "wall").start(strict); break;
     default: break;
   }
 }
 
 // _____________________________________________________________________________________________________________________
-void CodeBenchmarkHandler::stop(const std::string &name, uint8_t bm_t_id) {
+void CodeBenchmarkHandler::stop(const std::string &name, uint8_t bm_t_id, bool strict) {
   switch (bm_t_id) {
-    case 0: _threadCPU_benchmarks[name].stop(); break;
-    case 1: _totalCPU_benchmarks[name].stop(); break;
-    case 2: _threadWall_benchmarks[name].stop(); break;
-    case 3: _wall_benchmarks[name].stop(); break;
+    case 0: Lookup(_threadCPU_benchmarks, name, "thread_cpu").stop(strict); break;
+    case 1: Lookup(_totalCPU_benchmarks, name, "total_cpu").stop(strict); break;
+    case 2: Lookup(_threadWall_benchmarks, name, "thread_wall").stop(strict); break;
+    case 3: Lookup(_wall_benchmarks, name, "wall").stop(strict); break;
     default: break;
   }
 }
 
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+CodeBenchmarkHandler::CodeBenchmarkHandler() {
+  // enables the ring from the environment now, Lookup() and span() call Get() with their locks held
+  EventRing::Get();
+  EventRing::OnEnable([this](EventRing *eventRing) { AssignEventIds(eventRing); });
+}
+
+// _____________________________________________________________________________________________________________________
+void CodeBenchmarkHandler::AssignEventIds(EventRing *eventRing) {
+  std::unique_lock benchmarksLocker(_benchmarksMutex);
+  std::unique_lock spansLocker(_spansMutex);
+  auto assign = [eventRing](auto &benchmarks, const std::string &clock) {
+    for (auto &[name, benchmark]: benchmarks) {
+      if (benchmark.getEventId() == ring::kNoName) { benchmark.setEventId(eventRing->NameId(clock, name)); }
+    }
+  };
+  assign(_threadCPU_benchmarks, "thread_cpu");
+  assign(_totalCPU_benchmarks, "total_cpu");
+  assign(_threadWall_benchmarks, "thread_wall");
+  assign(_wall_benchmarks, "wall");
+  assign(_spans, "span");
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+T &CodeBenchmarkHandler::Lookup(std::map<const std::string, T> &benchmarks, const std::string &name,
+                                 const std::string &clock) {
+  {
+    std::shared_lock locker(_benchmarksMutex);
+    auto it = benchmarks.find(name);
+    if (it != benchmarks.end()) { return it->second; }
+  }
+  std::unique_lock locker(_benchmarksMutex);
+  auto [it, inserted] = benchmarks.try_emplace(name);
+  if (inserted && EventRing::Get() != nullptr) {
+    it->second.setEventId(EventRing::Get()->NameId(clock, name));
+  }
+  return it->second;
+}
+
 }  // namespace benchmarked
\ No newline at end of file
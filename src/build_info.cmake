@@ -0,0 +1,11 @@
+# Writes the git SHA of the project being built into OUTPUT. Run at build time (see src/CMakeLists.txt), so the SHA
+#  follows every commit without configuring again. configure_file() keeps the file untouched if nothing changed.
+execute_process(COMMAND git rev-parse HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE BENCHMARKED_GIT_SHA
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET)
+if (NOT BENCHMARKED_GIT_SHA)
+    set(BENCHMARKED_GIT_SHA "unknown")
+endif()
+configure_file(${INPUT} ${OUTPUT} @ONLY)
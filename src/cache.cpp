@@ -0,0 +1,101 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+#include "benchmarked/cache.h"
+#include "benchmarked/environment.h"
+
+#include "hwinfo/hwinfo.h"
+
+namespace benchmarked {
+
+static constexpr std::size_t CACHE_LINE_SIZE = 64;
+static constexpr std::size_t FALLBACK_LLC_SIZE = 32 * 1024 * 1024;
+
+// ===== CacheEvictor ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+CacheEvictor::CacheEvictor(bool remap) : _remap(remap), _size(2 * LastLevelCacheSize()) {
+  Map();
+}
+
+// _____________________________________________________________________________________________________________________
+CacheEvictor::~CacheEvictor() {
+  Unmap();
+}
+
+// _____________________________________________________________________________________________________________________
+void CacheEvictor::Evict() {
+  if (_remap) {
+    Unmap();
+    Map();
+  }
+  // read one byte per cache line: writing would leave dirty lines that are written back during the timed region
+  volatile char sink = 0;
+  char acc = 0;
+  for (std::size_t i = 0; i < _size; i += CACHE_LINE_SIZE) {
+    acc ^= _buffer[i];
+  }
+  sink = acc;
+  (void) sink;
+}
+
+// _____________________________________________________________________________________________________________________
+std::size_t CacheEvictor::LastLevelCacheSize() {
+  static const std::size_t size = []() -> std::size_t {
+    // the cache sizes of the environment snapshot do not require probing the hardware again
+    int64_t bytes = 0;
+    for (const auto &[name, cacheSize]: Environment::Get().caches) {
+      bytes = std::max(bytes, cacheSize);
+    }
+    if (bytes <= 0) {
+      hwinfo::CPU cpu;
+      bytes = cpu.cacheSize_Bytes();
+    }
+    return bytes > 0 ? static_cast<std::size_t>(bytes) : FALLBACK_LLC_SIZE;
+  }();
+  return size;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void CacheEvictor::Map() {
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+  // untouched anonymous pages are all backed by the same zero page, the buffer must be backed by distinct pages.
+  //  MAP_POPULATE faults them in within mmap() without writing to the buffer, so no dirty lines are left behind that
+  //  would be written back during the timed region.
+#ifdef MAP_POPULATE
+  void* ptr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if (ptr == MAP_FAILED) { throw std::bad_alloc(); }
+  _buffer = static_cast<char*>(ptr);
+#else
+  void* ptr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) { throw std::bad_alloc(); }
+  _buffer = static_cast<char*>(ptr);
+  // no way to fault in distinct pages without writing: the read-only sweep of Evict() writes the dirty lines back
+  std::memset(_buffer, 1, _size);
+#endif
+#else
+  _buffer = new char[_size]();
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void CacheEvictor::Unmap() {
+  if (_buffer == nullptr) { return; }
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+  munmap(_buffer, _size);
+#else
+  delete[] _buffer;
+#endif
+  _buffer = nullptr;
+}
+
+}  // namespace benchmarked
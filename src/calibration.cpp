@@ -0,0 +1,209 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "benchmarked/calibration.h"
+#include "benchmarked/cache.h"
+
+namespace benchmarked {
+
+namespace {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+constexpr std::size_t L1_WORKING_SET = 16 * 1024;
+constexpr std::size_t L2_WORKING_SET = 128 * 1024;
+constexpr std::size_t MAX_STREAM_ARRAY_SIZE = 32 * 1024 * 1024;
+constexpr std::size_t MAX_LATENCY_WORKING_SET = 128 * 1024 * 1024;
+
+// keeps the compiler from optimizing away computations whose results are not used otherwise
+template<typename T>
+inline void doNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile T sink;
+  sink = value;
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename F>
+double measure_ns(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count());
+}
+
+// _____________________________________________________________________________________________________________________
+void measureBandwidth(HostProfile &profile) {
+  std::size_t elements = std::min(4 * CacheEvictor::LastLevelCacheSize(), MAX_STREAM_ARRAY_SIZE) / sizeof(double);
+  std::vector<double> a(elements, 1.0);
+  std::vector<double> b(elements, 2.0);
+  std::vector<double> c(elements, 0.0);
+  const double scalar = 3.0;
+  double bytes = static_cast<double>(elements * sizeof(double));
+
+  // best of three like STREAM does
+  double copy_ns = INFINITY;
+  double triad_ns = INFINITY;
+  for (int rep = 0; rep < 3; ++rep) {
+    copy_ns = std::min(copy_ns, measure_ns([&]() {
+      for (std::size_t i = 0; i < elements; ++i) { c[i] = a[i]; }
+      doNotOptimize(c.data());
+    }));
+    triad_ns = std::min(triad_ns, measure_ns([&]() {
+      for (std::size_t i = 0; i < elements; ++i) { a[i] = b[i] + scalar * c[i]; }
+      doNotOptimize(a.data());
+    }));
+  }
+  profile.copyBandwidth_GBs = 2 * bytes / copy_ns;
+  profile.triadBandwidth_GBs = 3 * bytes / triad_ns;
+}
+
+// _____________________________________________________________________________________________________________________
+double measureLatency(std::size_t workingSet, std::size_t steps) {
+  // one pointer per cache line, linked in random order to defeat the prefetchers
+  std::size_t stride = CACHE_LINE_SIZE / sizeof(void *);
+  std::size_t nodes = std::max<std::size_t>(workingSet / CACHE_LINE_SIZE, 2);
+  std::vector<void *> memory(nodes * stride);
+  std::vector<std::size_t> order(nodes);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(nodes));
+  for (std::size_t i = 0; i < nodes; ++i) {
+    memory[order[i] * stride] = &memory[order[(i + 1) % nodes] * stride];
+  }
+
+  void **p = reinterpret_cast<void **>(memory[0]);
+  // warm up: one round through the working set
+  for (std::size_t i = 0; i < nodes; ++i) { p = reinterpret_cast<void **>(*p); }
+  double ns = measure_ns([&]() {
+    for (std::size_t i = 0; i < steps; ++i) { p = reinterpret_cast<void **>(*p); }
+  });
+  doNotOptimize(p);
+  return ns / static_cast<double>(steps);
+}
+
+// _____________________________________________________________________________________________________________________
+void measureLatencies(HostProfile &profile) {
+  std::size_t llc = CacheEvictor::LastLevelCacheSize();
+  profile.l1Latency_ns = measureLatency(L1_WORKING_SET, 1 << 20);
+  profile.l2Latency_ns = measureLatency(L2_WORKING_SET, 1 << 20);
+  // LLC and memory loads are slow: less steps keep the suite below its time budget
+  profile.llcLatency_ns = measureLatency(llc / 2, 1 << 18);
+  profile.memoryLatency_ns = measureLatency(std::min(4 * llc, MAX_LATENCY_WORKING_SET), 1 << 18);
+}
+
+// _____________________________________________________________________________________________________________________
+void measureOperations(HostProfile &profile) {
+  constexpr std::size_t N = 1 << 20;
+
+  std::mutex mutex;
+  profile.mutex_ns = measure_ns([&]() {
+    for (std::size_t i = 0; i < N; ++i) {
+      mutex.lock();
+      mutex.unlock();
+    }
+  }) / N;
+
+  std::atomic<uint64_t> counter(0);
+  profile.atomic_ns = measure_ns([&]() {
+    for (std::size_t i = 0; i < N; ++i) { counter.fetch_add(1); }
+  }) / N;
+  doNotOptimize(counter.load());
+
+  profile.mallocFree_ns = measure_ns([&]() {
+    for (std::size_t i = 0; i < N; ++i) {
+      void *ptr = std::malloc(64);
+      doNotOptimize(ptr);
+      std::free(ptr);
+    }
+  }) / N;
+
+  constexpr std::size_t SYSCALLS = 1 << 16;
+  profile.syscall_ns = measure_ns([&]() {
+    for (std::size_t i = 0; i < SYSCALLS; ++i) {
+#if defined(__linux__)
+      // glibc may cache getpid(), so the raw syscall is used
+      doNotOptimize(syscall(SYS_getppid));
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+      doNotOptimize(getppid());
+#endif
+    }
+  }) / SYSCALLS;
+}
+
+}  // namespace
+
+// ===== HostProfile ===================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::vector<std::pair<std::string, double>> HostProfile::Metrics() const {
+  return {
+      {"copy bandwidth [GB/s]", copyBandwidth_GBs},
+      {"triad bandwidth [GB/s]", triadBandwidth_GBs},
+      {"L1 latency [ns]", l1Latency_ns},
+      {"L2 latency [ns]", l2Latency_ns},
+      {"LLC latency [ns]", llcLatency_ns},
+      {"memory latency [ns]", memoryLatency_ns},
+      {"mutex lock/unlock [ns]", mutex_ns},
+      {"atomic increment [ns]", atomic_ns},
+      {"malloc/free [ns]", mallocFree_ns},
+      {"syscall [ns]", syscall_ns},
+  };
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::string> HostProfile::OffProfile(const HostProfile &reference, double tolerance) const {
+  std::vector<std::string> deviations;
+  auto metrics = Metrics();
+  auto referenceMetrics = reference.Metrics();
+  for (std::size_t i = 0; i < metrics.size(); ++i) {
+    const auto &[name, value] = metrics[i];
+    double expected = referenceMetrics[i].second;
+    if (expected <= 0) { continue; }
+    double deviation = (value - expected) / expected;
+    if (std::abs(deviation) > tolerance) {
+      std::stringstream ss;
+      ss << name << ": " << value << " (reference " << expected << ", " << (deviation > 0 ? "+" : "")
+         << deviation * 100 << "%)";
+      deviations.push_back(ss.str());
+    }
+  }
+  return deviations;
+}
+
+// _____________________________________________________________________________________________________________________
+const HostProfile &HostProfile::Get() {
+  static const HostProfile profile = Measure();
+  return profile;
+}
+
+// _____________________________________________________________________________________________________________________
+HostProfile HostProfile::Measure() {
+  HostProfile profile;
+  profile.duration_ms = measure_ns([&]() {
+    measureBandwidth(profile);
+    measureLatencies(profile);
+    measureOperations(profile);
+  }) / 1000 / 1000;
+  return profile;
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,235 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "benchmarked/category.h"
+
+namespace benchmarked {
+
+namespace {
+
+/**
+ * Selection: parsed selection string. Names are applied in order, so later entries override earlier ones. Only the
+ *  last entry of every name is kept (and none before "all" or "none"), so toggling a category at runtime does not grow
+ *  the selection.
+ */
+struct Selection {
+  std::vector<std::pair<std::string, bool>> entries;
+
+  void Add(const std::string& name, bool enable) {
+    if (name == "all" || name == "none") {
+      entries.clear();
+    } else {
+      entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const auto& entry) {
+        return entry.first == name;
+      }), entries.end());
+    }
+    entries.emplace_back(name, enable);
+  }
+
+  [[nodiscard]] bool Enables(const std::string& name) const {
+    bool enabled = false;
+    for (const auto& [entry, enable]: entries) {
+      if (entry == "all" || entry == name) { enabled = enable; }
+      if (entry == "none") { enabled = false; }
+    }
+    return enabled;
+  }
+};
+
+// _____________________________________________________________________________________________________________________
+Selection Parse(const std::string& selection) {
+  Selection parsed;
+  std::stringstream ss(selection);
+  std::string entry;
+  while (std::getline(ss, entry, ',')) {
+    entry.erase(0, entry.find_first_not_of(" \t\n"));
+    entry.erase(entry.find_last_not_of(" \t\n") + 1);
+    if (entry.empty()) { continue; }
+    if (entry[0] == '-') {
+      parsed.Add(entry.substr(1), false);
+    } else {
+      parsed.Add(entry, true);
+    }
+  }
+  return parsed;
+}
+
+/**
+ * Registry: all declared categories and the current selection, created on first use because categories are
+ *  declared during static initialization.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::vector<Category*> categories;
+  Selection selection;
+
+  static Registry& Get() {
+    static Registry registry;
+    return registry;
+  }
+
+ private:
+  Registry() {
+    const char* selected = std::getenv("BENCHMARKED_CATEGORIES");
+    if (selected != nullptr) { selection = Parse(selected); }
+  }
+};
+
+// the signal handler only writes to this pipe, everything else happens on the watcher thread
+int gSignalPipe[2] = {-1, -1};
+
+// _____________________________________________________________________________________________________________________
+extern "C" void OnSelectionSignal(int) {
+  char byte = 0;
+  [[maybe_unused]] auto written = ::write(gSignalPipe[1], &byte, 1);
+}
+
+}  // namespace
+
+// ===== Category ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Category::Category(const char *name) : _name(name) {
+  Categories::Register(this);
+}
+
+// _____________________________________________________________________________________________________________________
+Category::~Category() {
+  Categories::Unregister(this);
+}
+
+// ===== Categories ====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void Categories::Select(const std::string &selection) {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  registry.selection = Parse(selection);
+  for (auto *category: registry.categories) {
+    category->_enabled.store(registry.selection.Enables(category->_name), std::memory_order_relaxed);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void Categories::Enable(const std::string &name) {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  registry.selection.Add(name, true);
+  for (auto *category: registry.categories) {
+    if (name == "all" || name == category->_name) { category->_enabled.store(true, std::memory_order_relaxed); }
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void Categories::Disable(const std::string &name) {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  registry.selection.Add(name, false);
+  for (auto *category: registry.categories) {
+    if (name == "all" || name == category->_name) { category->_enabled.store(false, std::memory_order_relaxed); }
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::pair<std::string, bool>> Categories::List() {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  std::vector<std::pair<std::string, bool>> categories;
+  for (const auto *category: registry.categories) { categories.emplace_back(category->_name, category->Enabled()); }
+  return categories;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string Categories::Selection() {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  std::string selection;
+  for (const auto &[name, enable]: registry.selection.entries) {
+    if (!selection.empty()) { selection += ','; }
+    selection += (enable ? "" : "-") + name;
+  }
+  return selection;
+}
+
+// _____________________________________________________________________________________________________________________
+bool Categories::Load(const std::string &path) {
+  // O_NOFOLLOW and the checks on the opened file: the file can not be swapped between the checks and the read
+  int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC | O_NONBLOCK);
+  if (fd < 0) { return false; }
+  struct stat status{};
+  if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode) || status.st_uid != ::geteuid() ||
+      (status.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  std::string selection;
+  char buffer[4096];
+  ssize_t bytes;
+  while ((bytes = ::read(fd, buffer, sizeof(buffer))) > 0) { selection.append(buffer, bytes); }
+  ::close(fd);
+  if (bytes < 0) { return false; }
+  Select(selection);
+  return true;
+}
+
+// _____________________________________________________________________________________________________________________
+void Categories::InstallSignalHandler(const std::string &path, int signo) {
+  static std::once_flag installed;
+  std::call_once(installed, [&]() {
+    if (::pipe2(gSignalPipe, O_CLOEXEC) != 0) {
+      throw std::runtime_error("Installing category signal handler failed.");
+    }
+    std::string selectionPath = path;
+    if (selectionPath.empty()) {
+      const char *runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+      selectionPath = std::string(runtimeDir != nullptr && *runtimeDir != '\0' ? runtimeDir : "/tmp") +
+                      "/benchmarked-" + std::to_string(::getpid()) + ".categories";
+    }
+    std::thread([selectionPath]() {
+      char byte;
+      while (::read(gSignalPipe[0], &byte, 1) == 1) {
+        if (!Load(selectionPath)) {
+          std::cerr << "benchmarked: ignoring category selection " << selectionPath
+                    << ", it must be a regular file only accessible by its owner (the user of this process)"
+                    << std::endl;
+        }
+      }
+    }).detach();
+    struct sigaction action{};
+    action.sa_handler = OnSelectionSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(signo, &action, nullptr);
+  });
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void Categories::Register(Category *category) {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  registry.categories.push_back(category);
+  category->_enabled.store(registry.selection.Enables(category->_name), std::memory_order_relaxed);
+}
+
+// _____________________________________________________________________________________________________________________
+void Categories::Unregister(Category *category) {
+  auto &registry = Registry::Get();
+  std::unique_lock locker(registry.mutex);
+  registry.categories.erase(std::remove(registry.categories.begin(), registry.categories.end(), category),
+                            registry.categories.end());
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,347 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmarked/checkpoint.h"
+#include "benchmarked/calibration.h"
+
+namespace benchmarked {
+
+namespace {
+
+constexpr char HEADER[] = "benchmarked-checkpoint 1\n";
+
+// strings are written as "<length>:<bytes>", so they may contain any character
+// _____________________________________________________________________________________________________________________
+void writeString(std::ostream &os, const std::string &value) {
+  os << ' ' << value.size() << ':' << value;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string readString(std::istream &is) {
+  std::size_t length = 0;
+  if (!(is >> length) || is.get() != ':') {
+    is.setstate(std::ios::failbit);
+    return "";
+  }
+  std::string value(length, '\0');
+  is.read(value.data(), static_cast<std::streamsize>(length));
+  return value;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+void writeSeries(std::ostream &os, const std::vector<T> &values) {
+  os << ' ' << values.size();
+  for (const auto &value: values) { os << ' ' << value; }
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+std::vector<T> readSeries(std::istream &is) {
+  std::size_t size = 0;
+  is >> size;
+  std::vector<T> values;
+  for (std::size_t i = 0; i < size && is >> values.emplace_back(); ++i) {}
+  return values;
+}
+
+// _____________________________________________________________________________________________________________________
+void writeResults(std::ostream &os, const std::vector<Result> &results) {
+  os << ' ' << results.size();
+  for (const auto &result: results) {
+    os << ' ' << result.cpuTime.getNanoseconds() << ' ' << result.wallTime.getNanoseconds();
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<Result> readResults(std::istream &is) {
+  std::size_t size = 0;
+  is >> size;
+  std::vector<Result> results;
+  for (std::size_t i = 0; i < size; ++i) {
+    uint64_t cpu_ns = 0;
+    uint64_t wall_ns = 0;
+    if (!(is >> cpu_ns >> wall_ns)) { break; }
+    results.emplace_back(timed::Time(std::chrono::nanoseconds(cpu_ns)),
+                         timed::Time(std::chrono::nanoseconds(wall_ns)));
+  }
+  return results;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string key(const std::string &name, const std::string &type) {
+  return name + '\0' + type;
+}
+
+}  // namespace
+
+// ===== Checkpoint ====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Checkpoint::Checkpoint(const std::string &path, bool truncate) : _path(path) {
+  // a record cut off by a crash would otherwise be continued by the next one
+  std::size_t complete = 0;
+  if (!truncate) { Read(path, complete); }
+  _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+  if (_fd < 0 || (!truncate && ::ftruncate(_fd, static_cast<off_t>(complete)) != 0)) {
+    std::string error = std::strerror(errno);
+    if (_fd >= 0) { ::close(_fd); }
+    throw std::runtime_error("Opening checkpoint '" + path + "' failed: " + error);
+  }
+  // the header is written with the first record: the host profile is not calibrated while the options are parsed
+  _empty = ::lseek(_fd, 0, SEEK_END) == 0;
+}
+
+// _____________________________________________________________________________________________________________________
+Checkpoint::~Checkpoint() {
+  if (_fd >= 0) { ::close(_fd); }
+}
+
+// _____________________________________________________________________________________________________________________
+void Checkpoint::Append(const BenchmarkBase &benchmark) {
+  std::ostringstream os;
+  os << std::setprecision(17);
+  if (_empty) {
+    auto entries = Environment::Get().Entries();
+    auto metrics = HostProfile::Get().Metrics();
+    os << HEADER << "environment " << entries.size();
+    for (const auto &[name, value]: entries) {
+      writeString(os, name);
+      writeString(os, value);
+    }
+    os << "\nhost-profile " << metrics.size();
+    for (const auto &[name, value]: metrics) {
+      writeString(os, name);
+      os << ' ' << value;
+    }
+    os << '\n';
+  }
+  os << "benchmark";
+  writeString(os, benchmark._name);
+  writeString(os, benchmark._type);
+  writeString(os, benchmark._description);
+  writeString(os, benchmark._group);
+  os << ' ' << benchmark._iterations << ' ' << benchmark._timedOut << '\n';
+  // the options shown by the reporters
+  os << "options " << benchmark._options.asyncConcurrency << ' ' << static_cast<int>(benchmark._options.arrival) << ' '
+     << benchmark._options.openLoopWorkers << '\n';
+  os << "results";
+  writeString(os, benchmark._resultsLabel);
+  writeResults(os, benchmark._results);
+  os << '\n';
+  for (const auto &variant: benchmark._variants) {
+    os << "variant";
+    writeString(os, variant.label);
+    writeResults(os, variant.results);
+    os << '\n';
+  }
+  if (benchmark._comparison) {
+    const auto &comparison = *benchmark._comparison;
+    os << "comparison " << comparison.value << ' ' << comparison.low << ' ' << comparison.high << ' '
+       << comparison.confidence << '\n';
+  }
+  for (const auto &point: benchmark._loadCurve) {
+    os << "load " << point.offeredRate << ' ' << point.achievedRate << ' ' << point.saturated;
+    writeSeries(os, point.latencies_ns);
+    os << '\n';
+  }
+  if (!benchmark._latencies_ns.empty()) {
+    os << "latencies";
+    writeSeries(os, benchmark._latencies_ns);
+    os << '\n';
+  }
+  for (const auto &run: benchmark._processRuns) {
+    os << "process " << run.user_ns << ' ' << run.sys_ns << ' ' << run.peakRss_kb << '\n';
+  }
+  for (const auto &role: benchmark._roleResults) {
+    const auto &histogram = role.latencies;
+    os << "role";
+    writeString(os, role.name);
+    os << ' ' << role.threads << ' ' << role.operations << ' ' << role.wall_ns << ' ' << histogram._count << ' '
+       << histogram._min << ' ' << histogram._max << ' ' << histogram._sum;
+    // only the buckets in use, as (index, count) pairs
+    std::size_t used = 0;
+    for (auto count: histogram._buckets) { used += count != 0; }
+    os << ' ' << used;
+    for (std::size_t i = 0; i < histogram._buckets.size(); ++i) {
+      if (histogram._buckets[i] != 0) { os << ' ' << i << ' ' << histogram._buckets[i]; }
+    }
+    os << '\n';
+  }
+  if (!benchmark._startSkew_ns.empty()) {
+    os << "skew";
+    writeSeries(os, benchmark._startSkew_ns);
+    os << '\n';
+  }
+  for (const auto &io: benchmark._io) {
+    os << "io " << io.rchar << ' ' << io.wchar << ' ' << io.syscr << ' ' << io.syscw << ' ' << io.readBytes << ' '
+       << io.writeBytes << ' ' << io.cancelledWriteBytes << '\n';
+  }
+  os << "end\n";
+
+  std::string record = os.str();
+  if (::write(_fd, record.data(), record.size()) != static_cast<ssize_t>(record.size()) || ::fdatasync(_fd) != 0) {
+    throw std::runtime_error("Writing checkpoint '" + _path + "' failed: " + std::strerror(errno));
+  }
+  _empty = false;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::shared_ptr<BenchmarkBase>> Checkpoint::Load(const std::string &path) {
+  std::size_t complete = 0;
+  return Read(path, complete);
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::shared_ptr<BenchmarkBase>> Checkpoint::Merge(const std::vector<std::string> &paths) {
+  std::vector<std::shared_ptr<BenchmarkBase>> benchmarks;
+  std::map<std::string, std::size_t> indices;
+  for (const auto &path: paths) {
+    if (!std::ifstream(path)) { throw std::runtime_error("Opening checkpoint '" + path + "' failed."); }
+    for (auto &benchmark: Load(path)) {
+      auto [it, inserted] = indices.emplace(key(benchmark->_name, benchmark->_type), benchmarks.size());
+      if (inserted) {
+        benchmarks.push_back(benchmark);
+      } else {
+        benchmarks[it->second] = benchmark;
+      }
+    }
+  }
+  return benchmarks;
+}
+
+// _____________________________________________________________________________________________________________________
+RecordedEnvironment Checkpoint::LoadEnvironment(const std::string &path) {
+  std::size_t complete = 0;
+  RecordedEnvironment environment;
+  Read(path, complete, &environment);
+  return environment;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::vector<std::shared_ptr<BenchmarkBase>> Checkpoint::Read(const std::string &path, std::size_t &complete,
+                                                             RecordedEnvironment *environment) {
+  complete = 0;
+  std::ifstream file(path);
+  // not created yet or created by a process that was killed right away
+  if (!file || file.peek() == std::ifstream::traits_type::eof()) { return {}; }
+  std::string header;
+  if (!std::getline(file, header) || header + '\n' != HEADER) {
+    throw std::runtime_error("'" + path + "' is not a checkpoint.");
+  }
+
+  RecordedEnvironment recorded;
+  std::string field;
+  std::size_t count = 0;
+  if (file >> field && field == "environment" && file >> count) {
+    for (std::size_t i = 0; i < count && file; ++i) {
+      auto name = readString(file);
+      recorded.entries.emplace_back(name, readString(file));
+    }
+  } else {
+    file.setstate(std::ios::failbit);
+  }
+  if (file >> field && field == "host-profile" && file >> count) {
+    for (std::size_t i = 0; i < count && file; ++i) {
+      auto name = readString(file);
+      file >> recorded.hostProfile.emplace_back(name, 0).second;
+    }
+  } else {
+    file.setstate(std::ios::failbit);
+  }
+  // the header was cut off with the first record, it is written again with the next one
+  if (!file || file.get() != '\n') { return {}; }
+  complete = static_cast<std::size_t>(file.tellg());
+  if (environment != nullptr) { *environment = std::move(recorded); }
+
+  std::vector<std::shared_ptr<BenchmarkBase>> benchmarks;
+  std::map<std::string, std::size_t> indices;
+  while (file >> field && field == "benchmark") {
+    auto benchmark = std::make_shared<RecordedBenchmark>();
+    BenchmarkBase &bm = *benchmark;
+    bm._name = readString(file);
+    bm._type = readString(file);
+    bm._description = readString(file);
+    bm._group = readString(file);
+    file >> bm._iterations >> bm._timedOut;
+    bm._launched = true;
+    while (file >> field && field != "end") {
+      if (field == "options") {
+        int arrival = 0;
+        file >> bm._options.asyncConcurrency >> arrival >> bm._options.openLoopWorkers;
+        bm._options.arrival = static_cast<Arrival>(arrival);
+      } else if (field == "results") {
+        bm._resultsLabel = readString(file);
+        bm._results = readResults(file);
+      } else if (field == "variant") {
+        auto &variant = bm._variants.emplace_back();
+        variant.label = readString(file);
+        variant.results = readResults(file);
+      } else if (field == "comparison") {
+        statistics::Estimate comparison;
+        file >> comparison.value >> comparison.low >> comparison.high >> comparison.confidence;
+        // paired ratios always come from BootstrapPairedRatio()
+        comparison.method = statistics::IntervalMethod::PercentileBootstrap;
+        bm._comparison = comparison;
+      } else if (field == "load") {
+        auto &point = bm._loadCurve.emplace_back();
+        file >> point.offeredRate >> point.achievedRate >> point.saturated;
+        point.latencies_ns = readSeries<uint64_t>(file);
+      } else if (field == "latencies") {
+        bm._latencies_ns = readSeries<uint64_t>(file);
+      } else if (field == "process") {
+        auto &run = bm._processRuns.emplace_back();
+        file >> run.user_ns >> run.sys_ns >> run.peakRss_kb;
+      } else if (field == "role") {
+        auto &role = bm._roleResults.emplace_back();
+        auto &histogram = role.latencies;
+        role.name = readString(file);
+        std::size_t used = 0;
+        file >> role.threads >> role.operations >> role.wall_ns >> histogram._count >> histogram._min >> histogram._max
+             >> histogram._sum >> used;
+        for (std::size_t i = 0; i < used; ++i) {
+          std::size_t index = 0;
+          uint64_t count = 0;
+          if (!(file >> index >> count) || index >= histogram._buckets.size()) {
+            file.setstate(std::ios::failbit);
+            break;
+          }
+          histogram._buckets[index] = count;
+        }
+      } else if (field == "skew") {
+        bm._startSkew_ns = readSeries<int64_t>(file);
+      } else if (field == "io") {
+        auto &io = bm._io.emplace_back();
+        file >> io.rchar >> io.wchar >> io.syscr >> io.syscw >> io.readBytes >> io.writeBytes
+             >> io.cancelledWriteBytes;
+      } else {
+        file.setstate(std::ios::failbit);
+      }
+    }
+    // the last record was cut off
+    if (!file || field != "end" || file.get() != '\n') { break; }
+    complete = static_cast<std::size_t>(file.tellg());
+
+    auto [it, inserted] = indices.emplace(key(bm._name, bm._type), benchmarks.size());
+    if (inserted) {
+      benchmarks.push_back(benchmark);
+    } else {
+      benchmarks[it->second] = benchmark;
+    }
+  }
+  return benchmarks;
+}
+
+}  // namespace benchmarked
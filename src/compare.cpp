@@ -0,0 +1,123 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <optional>
+#include <random>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "benchmarked/compare.h"
+#include "benchmarked/statistics.h"
+#include "timed/Timer.h"
+
+namespace benchmarked {
+
+namespace {
+
+/**
+ * Pins the calling thread to the core it is running on and restores the previous affinity when destroyed.
+ */
+class CurrentCorePin {
+ public:
+  CurrentCorePin() {
+#if defined(__linux__)
+    if (sched_getaffinity(0, sizeof(_previousAffinity), &_previousAffinity) == 0) {
+      cpu_set_t affinity;
+      CPU_ZERO(&affinity);
+      CPU_SET(sched_getcpu(), &affinity);
+      _pinned = sched_setaffinity(0, sizeof(affinity), &affinity) == 0;
+    }
+#endif
+  }
+  CurrentCorePin(const CurrentCorePin&) = delete;
+  CurrentCorePin(CurrentCorePin&&) = delete;
+  ~CurrentCorePin() {
+#if defined(__linux__)
+    if (_pinned) { sched_setaffinity(0, sizeof(_previousAffinity), &_previousAffinity); }
+#endif
+  }
+
+  CurrentCorePin& operator=(const CurrentCorePin&) = delete;
+  CurrentCorePin& operator=(CurrentCorePin&&) = delete;
+
+ private:
+#if defined(__linux__)
+  cpu_set_t _previousAffinity{};
+#endif
+  bool _pinned = false;
+};
+
+}  // namespace
+
+// ===== CompareBenchmark ==============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+CompareBenchmark::CompareBenchmark(std::function<void()> a, std::function<void()> b, std::string labelA,
+                                   std::string labelB, const std::string &name, const std::string &type,
+                                   const std::string &description, uint64_t iterations, BenchmarkOptions options)
+    : BenchmarkBase(name, type, description, iterations, []() {}, std::move(options)), _a(std::move(a)),
+      _b(std::move(b)) {
+  _resultsLabel = std::move(labelA);
+  _variants.push_back({std::move(labelB), {}});
+}
+
+// _____________________________________________________________________________________________________________________
+void CompareBenchmark::Launch() {
+  // both variants must see the same core, also restored if a variant throws
+  CurrentCorePin pin;
+
+  // untimed warm up run of both variants, under the same time limit as an iteration
+  {
+    auto armed = ArmWatchdog();
+    _a();
+    _b();
+  }
+
+  std::mt19937_64 rng(_iterations);
+  std::bernoulli_distribution aFirst(0.5);
+  auto &resultsB = _variants.front().results;
+  for (uint64_t iteration = 0; iteration < _iterations && !DeadlineReached(); ++iteration) {
+    auto armed = ArmWatchdog();
+    std::optional<Result> a;
+    std::optional<Result> b;
+    if (aFirst(rng)) {
+      a = Measure(_a);
+      b = Measure(_b);
+    } else {
+      b = Measure(_b);
+      a = Measure(_a);
+    }
+    armed.Disarm();
+    Record([&]() {
+      _results.push_back(*a);
+      resultsB.push_back(*b);
+    });
+  }
+
+  std::vector<double> wallA;
+  std::vector<double> wallB;
+  for (std::size_t i = 0; i < _results.size(); ++i) {
+    wallA.push_back(static_cast<double>(_results[i].wallTime.getNanoseconds()));
+    wallB.push_back(static_cast<double>(resultsB[i].wallTime.getNanoseconds()));
+  }
+  auto comparison = statistics::BootstrapPairedRatio(wallA, wallB);
+  Record([&]() { _comparison = comparison; });
+  _launched = true;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Result CompareBenchmark::Measure(const std::function<void()> &f) {
+  timed::WallTimer wall_timer;
+  timed::CPUTimer cpu_timer;
+  wall_timer.start();
+  cpu_timer.start();
+  f();
+  cpu_timer.stop();
+  wall_timer.stop();
+  return {cpu_timer.getTime(), wall_timer.getTime()};
+}
+
+}  // namespace benchmarked
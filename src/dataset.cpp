@@ -0,0 +1,248 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "benchmarked/dataset.h"
+
+namespace benchmarked {
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'M', 'D', 'A', 'T', 'A', '0', '1'};
+// the data starts at the second page, so every alignment up to the page size is preserved by the mapping
+constexpr uint64_t DATA_OFFSET = 4096;
+constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+struct FileHeader {
+  char magic[8];
+  uint64_t seed;
+  uint32_t version;
+  uint32_t complete;  // written last
+  uint64_t size;
+  char generator[64];
+};
+static_assert(sizeof(FileHeader) <= DATA_OFFSET);
+
+// _____________________________________________________________________________________________________________________
+std::filesystem::path cacheDirectory(const DatasetOptions &options) {
+  if (!options.directory.empty()) { return options.directory; }
+  const char *cache = std::getenv("BENCHMARKED_DATASET_CACHE");
+  if (cache != nullptr && *cache != '\0') { return cache; }
+  const char *xdgCache = std::getenv("XDG_CACHE_HOME");
+  const char *home = std::getenv("HOME");
+  std::filesystem::path dir;
+  if (xdgCache != nullptr && *xdgCache != '\0') {
+    dir = xdgCache;
+  } else if (home != nullptr && *home != '\0') {
+    dir = std::filesystem::path(home) / ".cache";
+  } else {
+    dir = std::filesystem::temp_directory_path();
+  }
+  return dir / "benchmarked" / "datasets";
+}
+
+// _____________________________________________________________________________________________________________________
+std::string fileName(const DatasetKey &key) {
+  std::string generator = key.generator;
+  for (char &c: generator) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.') { c = '_'; }
+  }
+  return generator + "-" + std::to_string(key.seed) + "-v" + std::to_string(key.version);
+}
+
+// _____________________________________________________________________________________________________________________
+void writeAll(int fd, const char *data, std::size_t bytes, uint64_t offset) {
+  while (bytes > 0) {
+    ssize_t written = ::pwrite(fd, data, bytes, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR) { continue; }
+    if (written <= 0) {
+      throw std::runtime_error(std::string("Writing dataset failed: ") + std::strerror(errno));
+    }
+    data += written;
+    bytes -= static_cast<std::size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+}
+
+}  // namespace
+
+// ===== DatasetWriter =================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void DatasetWriter::Patch(uint64_t offset, const void *data, std::size_t bytes) {
+  if (offset + bytes > _size) { throw std::out_of_range("Patching dataset beyond the written data."); }
+  const char *source = static_cast<const char *>(data);
+  if (offset < _flushed) {
+    std::size_t inFile = std::min<uint64_t>(bytes, _flushed - offset);
+    writeAll(_fd, source, inFile, _base + offset);
+    source += inFile;
+    bytes -= inFile;
+    offset += inFile;
+  }
+  std::memcpy(_buffer.data() + (offset - _flushed), source, bytes);
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+uint64_t DatasetWriter::WriteBytes(const void *data, std::size_t bytes, std::size_t alignment) {
+  uint64_t padding = (alignment - _size % alignment) % alignment;
+  _buffer.insert(_buffer.end(), padding, '\0');
+  uint64_t offset = _size + padding;
+  _size = offset + bytes;
+  if (_buffer.size() + bytes > BUFFER_SIZE) {
+    Flush();
+    // large blocks are not copied through the buffer
+    if (bytes > BUFFER_SIZE) {
+      writeAll(_fd, static_cast<const char *>(data), bytes, _base + offset);
+      _flushed += bytes;
+      return offset;
+    }
+  }
+  const char *source = static_cast<const char *>(data);
+  _buffer.insert(_buffer.end(), source, source + bytes);
+  return offset;
+}
+
+// _____________________________________________________________________________________________________________________
+void DatasetWriter::Flush() {
+  writeAll(_fd, _buffer.data(), _buffer.size(), _base + _flushed);
+  _flushed += _buffer.size();
+  _buffer.clear();
+}
+
+// ===== Dataset =======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Dataset::Dataset(const DatasetKey &key, const Generator &generate, const DatasetOptions &options) {
+  auto directory = cacheDirectory(options);
+  _path = (directory / fileName(key)).string();
+  if (Map(key, options)) { return; }
+
+  std::filesystem::create_directories(directory);
+  // concurrently started processes wait for the one generating the data instead of generating it as well
+  std::string lockPath = _path + ".lock";
+  int lock = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (lock < 0 || ::flock(lock, LOCK_EX) != 0) {
+    std::string error = std::strerror(errno);
+    if (lock >= 0) { ::close(lock); }
+    throw std::runtime_error("Locking dataset '" + _path + "' failed: " + error);
+  }
+  try {
+    if (!Map(key, options)) {
+      Generate(key, generate);
+      _generated = true;
+      if (!Map(key, options)) { throw std::runtime_error("Dataset '" + _path + "' is invalid after generating it."); }
+    }
+  } catch (...) {
+    ::close(lock);
+    throw;
+  }
+  ::close(lock);
+}
+
+// _____________________________________________________________________________________________________________________
+Dataset::~Dataset() {
+  if (_mapping != nullptr) { munmap(_mapping, _mappingSize); }
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+bool Dataset::Map(const DatasetKey &key, const DatasetOptions &options) {
+  int fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) { return false; }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < DATA_OFFSET) {
+    ::close(fd);
+    return false;
+  }
+  auto size = static_cast<std::size_t>(st.st_size);
+  int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+  if (options.populate) { flags |= MAP_POPULATE; }
+#endif
+  void *ptr = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error("Mapping dataset '" + _path + "' failed: " + std::strerror(errno));
+  }
+
+  const auto *header = static_cast<const FileHeader *>(ptr);
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->complete != 1 || header->seed != key.seed ||
+      header->version != key.version || header->size != size - DATA_OFFSET ||
+      key.generator.substr(0, sizeof(header->generator) - 1) !=
+          std::string_view(header->generator, strnlen(header->generator, sizeof(header->generator)))) {
+    munmap(ptr, size);
+    return false;
+  }
+#if defined(MADV_HUGEPAGE)
+  if (options.hugePages) { madvise(ptr, size, MADV_HUGEPAGE); }
+#endif
+  _mapping = ptr;
+  _mappingSize = size;
+  _data = static_cast<const char *>(ptr) + DATA_OFFSET;
+  _size = header->size;
+  return true;
+}
+
+// _____________________________________________________________________________________________________________________
+void Dataset::Generate(const DatasetKey &key, const Generator &generate) {
+  // rename() is atomic, so other processes never map a partially written file
+  std::string tmpPath = _path + ".tmp." + std::to_string(::getpid());
+  int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Creating dataset '" + tmpPath + "' failed: " + std::strerror(errno));
+  }
+  try {
+    DatasetWriter writer(fd, DATA_OFFSET);
+    generate(writer);
+    writer.Flush();
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.seed = key.seed;
+    header.version = key.version;
+    header.complete = 1;
+    header.size = writer.Size();
+    std::strncpy(header.generator, key.generator.c_str(), sizeof(header.generator) - 1);
+    if (::ftruncate(fd, static_cast<off_t>(DATA_OFFSET + writer.Size())) != 0) {
+      throw std::runtime_error("Writing dataset '" + tmpPath + "' failed: " + std::strerror(errno));
+    }
+    writeAll(fd, reinterpret_cast<const char *>(&header), sizeof(header), 0);
+    // the data must be on disk before the rename is, or a crash could leave a complete header over missing data
+    if (::fsync(fd) != 0) {
+      throw std::runtime_error("Writing dataset '" + tmpPath + "' failed: " + std::strerror(errno));
+    }
+  } catch (...) {
+    ::close(fd);
+    ::unlink(tmpPath.c_str());
+    throw;
+  }
+  ::close(fd);
+  if (std::rename(tmpPath.c_str(), _path.c_str()) != 0) {
+    std::string error = std::strerror(errno);
+    ::unlink(tmpPath.c_str());
+    throw std::runtime_error("Storing dataset '" + _path + "' failed: " + error);
+  }
+  // persist the rename itself, best effort: the dataset is valid either way and would only be generated again
+  std::string directory = std::filesystem::path(_path).parent_path().string();
+  int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirFd >= 0) {
+    ::fsync(dirFd);
+    ::close(dirFd);
+  }
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,301 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+#include <sys/utsname.h>
+#endif
+
+#include "benchmarked/environment.h"
+
+#include "hwinfo/hwinfo.h"
+
+#if __has_include("benchmarked/build_info.h")
+#include "benchmarked/build_info.h"
+#endif
+
+#ifndef BENCHMARKED_GIT_SHA
+#define BENCHMARKED_GIT_SHA "unknown"
+#endif
+#ifndef BENCHMARKED_BUILD_TYPE
+#define BENCHMARKED_BUILD_TYPE "unknown"
+#endif
+#ifndef BENCHMARKED_BUILD_FLAGS
+#define BENCHMARKED_BUILD_FLAGS ""
+#endif
+
+namespace benchmarked {
+
+namespace {
+
+// environment variables that are known to change performance characteristics
+const char *const RELEVANT_VARIABLES[] = {
+    "OMP_NUM_THREADS", "OMP_PROC_BIND", "MALLOC_ARENA_MAX", "GLIBC_TUNABLES", "LD_PRELOAD", "LD_BIND_NOW",
+};
+
+// _____________________________________________________________________________________________________________________
+std::string readFirstLine(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+// _____________________________________________________________________________________________________________________
+bool parseInt(const std::string &value, int64_t &result) {
+  auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+  return ec == std::errc() && end == value.data() + value.size();
+}
+
+// _____________________________________________________________________________________________________________________
+std::filesystem::path cacheFilePath() {
+  const char *xdgCache = std::getenv("XDG_CACHE_HOME");
+  const char *home = std::getenv("HOME");
+  std::filesystem::path dir;
+  if (xdgCache != nullptr && *xdgCache != '\0') {
+    dir = xdgCache;
+  } else if (home != nullptr && *home != '\0') {
+    dir = std::filesystem::path(home) / ".cache";
+  } else {
+    dir = std::filesystem::temp_directory_path();
+  }
+  return dir / "benchmarked" / "environment";
+}
+
+// _____________________________________________________________________________________________________________________
+std::string compilerName() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void collectHardware(Environment &env) {
+  hwinfo::CPU cpu;
+  hwinfo::RAM ram;
+  env.cpuModel = cpu.modelName();
+  env.logicalCores = cpu.numLogicalCores();
+  env.physicalCores = cpu.numPhysicalCores();
+  env.regularClockSpeed_kHz = cpu.regularClockSpeed_kHz();
+  env.maxClockSpeed_kHz = cpu.maxClockSpeed_kHz();
+  env.ramSize_Bytes = ram.totalSize_Bytes();
+
+#if defined(__linux__)
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  for (const auto &entry: fs::directory_iterator("/sys/devices/system/cpu/cpu0/cache", ec)) {
+    if (entry.path().filename().string().rfind("index", 0) != 0) { continue; }
+    std::string level = readFirstLine(entry.path() / "level");
+    std::string type = readFirstLine(entry.path() / "type");
+    std::string size = readFirstLine(entry.path() / "size");
+    if (size.empty()) { continue; }
+    int64_t bytes = 0;
+    char unit = size.back();
+    if (unit == 'K' || unit == 'M') { size.pop_back(); }
+    if (!parseInt(size, bytes)) { continue; }
+    if (unit == 'K') { bytes *= 1024; }
+    if (unit == 'M') { bytes *= 1024 * 1024; }
+    std::string name = "L" + level + (type == "Data" ? "d" : type == "Instruction" ? "i" : "");
+    env.caches.emplace_back(name, bytes);
+  }
+  std::sort(env.caches.begin(), env.caches.end());
+  for (const auto &entry: fs::directory_iterator("/sys/devices/system/node", ec)) {
+    if (entry.path().filename().string().rfind("node", 0) == 0) { env.numaNodes++; }
+  }
+#endif
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+  utsname name{};
+  if (uname(&name) == 0) {
+    env.kernel = std::string(name.sysname) + " " + name.release + " " + name.machine;
+  }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void collectSoftware(Environment &env) {
+  env.compiler = compilerName();
+  env.buildType = BENCHMARKED_BUILD_TYPE;
+  env.buildFlags = BENCHMARKED_BUILD_FLAGS;
+  env.gitSha = BENCHMARKED_GIT_SHA;
+#if defined(__linux__)
+  env.cpuGovernor = readFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+#endif
+  for (const char *variable: RELEVANT_VARIABLES) {
+    const char *value = std::getenv(variable);
+    if (value != nullptr) {
+      env.variables.emplace_back(variable, value);
+    }
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+std::string currentBootId() {
+#if defined(__linux__)
+  return readFirstLine("/proc/sys/kernel/random/boot_id");
+#else
+  return "";
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+bool loadHardware(const std::filesystem::path &path, const std::string &bootId, Environment &env) {
+  std::ifstream file(path);
+  std::string line;
+  if (bootId.empty() || !std::getline(file, line) || line != "boot_id=" + bootId) { return false; }
+  env.bootId = bootId;
+  // a corrupted or truncated file is collected and written again
+  while (std::getline(file, line)) {
+    auto separator = line.find('=');
+    if (separator == std::string::npos) { return false; }
+    std::string key = line.substr(0, separator);
+    std::string value = line.substr(separator + 1);
+    bool valid = true;
+    if (key == "cpu_model") { env.cpuModel = value; }
+    else if (key == "logical_cores") { valid = parseInt(value, env.logicalCores); }
+    else if (key == "physical_cores") { valid = parseInt(value, env.physicalCores); }
+    else if (key == "numa_nodes") { valid = parseInt(value, env.numaNodes); }
+    else if (key == "regular_clock_khz") { valid = parseInt(value, env.regularClockSpeed_kHz); }
+    else if (key == "max_clock_khz") { valid = parseInt(value, env.maxClockSpeed_kHz); }
+    else if (key == "ram_bytes") { valid = parseInt(value, env.ramSize_Bytes); }
+    else if (key == "kernel") { env.kernel = value; }
+    else if (key.rfind("cache.", 0) == 0) { valid = parseInt(value, env.caches.emplace_back(key.substr(6), 0).second); }
+    if (!valid) { return false; }
+  }
+  return !env.cpuModel.empty();
+}
+
+// _____________________________________________________________________________________________________________________
+void storeHardware(const std::filesystem::path &path, const Environment &env) {
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  // write to a temporary file first: concurrently started benchmark binaries must never read a partial file
+  auto tmpPath = path;
+  tmpPath += "." + std::to_string(std::random_device()());
+  {
+    std::ofstream file(tmpPath);
+    if (!file) { return; }
+    file << "boot_id=" << env.bootId << '\n'
+         << "cpu_model=" << env.cpuModel << '\n'
+         << "logical_cores=" << env.logicalCores << '\n'
+         << "physical_cores=" << env.physicalCores << '\n'
+         << "numa_nodes=" << env.numaNodes << '\n'
+         << "regular_clock_khz=" << env.regularClockSpeed_kHz << '\n'
+         << "max_clock_khz=" << env.maxClockSpeed_kHz << '\n'
+         << "ram_bytes=" << env.ramSize_Bytes << '\n'
+         << "kernel=" << env.kernel << '\n';
+    for (const auto &[name, size]: env.caches) {
+      file << "cache." << name << "=" << size << '\n';
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) { std::filesystem::remove(tmpPath, ec); }
+}
+
+}  // namespace
+
+// ===== Environment ===================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::vector<std::pair<std::string, std::string>> Environment::Entries() const {
+  std::vector<std::pair<std::string, std::string>> entries = {
+      {"cpu model", cpuModel},
+      {"logical cores", std::to_string(logicalCores)},
+      {"physical cores", std::to_string(physicalCores)},
+      {"numa nodes", std::to_string(numaNodes)},
+      {"regular clock [kHz]", std::to_string(regularClockSpeed_kHz)},
+      {"max clock [kHz]", std::to_string(maxClockSpeed_kHz)},
+  };
+  for (const auto &[name, size]: caches) {
+    entries.emplace_back(name + " cache [KiB]", std::to_string(size / 1024));
+  }
+  entries.insert(entries.end(), {
+      {"ram [bytes]", std::to_string(ramSize_Bytes)},
+      {"kernel", kernel},
+      {"compiler", compiler},
+      {"library build type", buildType},
+      {"library build flags", buildFlags},
+      {"git sha", gitSha},
+      {"cpu governor", cpuGovernor},
+  });
+  for (const auto &[name, value]: variables) {
+    entries.emplace_back("$" + name, value);
+  }
+  return entries;
+}
+
+// _____________________________________________________________________________________________________________________
+const Environment &Environment::Get() {
+  static const Environment env = []() {
+    Environment env;
+    auto path = cacheFilePath();
+    auto bootId = currentBootId();
+    if (!loadHardware(path, bootId, env)) {
+      env = Environment();
+      env.bootId = bootId;
+      collectHardware(env);
+      if (!bootId.empty()) { storeHardware(path, env); }
+    }
+    collectSoftware(env);
+    return env;
+  }();
+  return env;
+}
+
+// _____________________________________________________________________________________________________________________
+Environment Environment::Collect() {
+  Environment env;
+  env.bootId = currentBootId();
+  collectHardware(env);
+  collectSoftware(env);
+  return env;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::string> RecordedEnvironment::Differences(const RecordedEnvironment &reference,
+                                                          double tolerance) const {
+  std::vector<std::string> differences;
+  std::map<std::string, std::string> entryValues(entries.begin(), entries.end());
+  std::map<std::string, std::string> referenceEntries(reference.entries.begin(), reference.entries.end());
+  for (const auto &[name, value]: referenceEntries) {
+    auto it = entryValues.find(name);
+    if (it == entryValues.end()) {
+      differences.push_back(name + ": missing (reference " + value + ")");
+    } else if (it->second != value) {
+      differences.push_back(name + ": " + it->second + " (reference " + value + ")");
+    }
+  }
+  for (const auto &[name, value]: entryValues) {
+    if (referenceEntries.count(name) == 0) { differences.push_back(name + ": " + value + " (reference missing)"); }
+  }
+
+  std::map<std::string, double> referenceMetrics(reference.hostProfile.begin(), reference.hostProfile.end());
+  for (const auto &[name, value]: hostProfile) {
+    auto it = referenceMetrics.find(name);
+    if (it == referenceMetrics.end() || it->second <= 0) { continue; }
+    double deviation = (value - it->second) / it->second;
+    if (std::abs(deviation) > tolerance) {
+      std::stringstream ss;
+      ss << name << ": " << value << " (reference " << it->second << ", " << (deviation > 0 ? "+" : "")
+         << deviation * 100 << "%)";
+      differences.push_back(ss.str());
+    }
+  }
+  return differences;
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,283 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "benchmarked/event_ring.h"
+
+namespace benchmarked {
+
+namespace ring {
+
+// _____________________________________________________________________________________________________________________
+std::size_t NamesOffset() {
+  return sizeof(FileHeader);
+}
+
+// _____________________________________________________________________________________________________________________
+std::size_t RingOffset(const FileHeader &header, uint32_t ring) {
+  return NamesOffset() + header.maxNames * kNameLength + ring * (sizeof(RingHeader) + header.capacity * sizeof(Slot));
+}
+
+// _____________________________________________________________________________________________________________________
+std::size_t FileSize(uint32_t maxThreads, uint32_t capacity, uint32_t maxNames) {
+  return NamesOffset() + maxNames * kNameLength + maxThreads * (sizeof(RingHeader) + capacity * sizeof(Slot));
+}
+
+}  // namespace ring
+
+namespace {
+
+std::mutex gEnableMutex;
+// never destroyed: threads may still publish while static objects are destroyed at exit
+std::atomic<EventRing *> gEventRing{nullptr};
+// callbacks of OnEnable() waiting for the ring
+std::vector<std::function<void(EventRing *)>> gEnableCallbacks;
+
+}  // namespace
+
+/**
+ * ThreadRing: the ring claimed by a thread on its first event, returned to the free rings when the thread exits.
+ */
+struct EventRing::ThreadRing {
+  ~ThreadRing() {
+    if (header != nullptr) { gEventRing.load(std::memory_order_acquire)->Release(index); }
+  }
+
+  bool claimed = false;
+  uint32_t index = 0;
+  ring::RingHeader *header = nullptr;
+};
+
+// ===== EventRing =====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+EventRing *EventRing::Get() {
+  static EventRing *fromEnvironment = []() -> EventRing * {
+    const char *path = std::getenv("BENCHMARKED_EVENT_RING");
+    if (path == nullptr || *path == '\0') { return nullptr; }
+    return Enable(std::strcmp(path, "1") == 0 ? "" : path);
+  }();
+  (void) fromEnvironment;
+  return gEventRing.load(std::memory_order_acquire);
+}
+
+// _____________________________________________________________________________________________________________________
+EventRing *EventRing::Enable(const std::string &path, uint32_t maxThreads, uint32_t capacity, uint32_t maxNames) {
+  std::unique_lock locker(gEnableMutex);
+  if (auto *current = gEventRing.load(std::memory_order_acquire)) { return current; }
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+    throw std::invalid_argument("The capacity of an event ring must be a power of two.");
+  }
+  auto *eventRing = new EventRing(path.empty() ? "/dev/shm/benchmarked-" + std::to_string(::getpid()) : path,
+                                  maxThreads, capacity, maxNames);
+  gEventRing.store(eventRing, std::memory_order_release);
+  // readers that are still attached keep their mapping
+  std::atexit([]() { ::unlink(gEventRing.load()->Path().c_str()); });
+  // run without the lock, the callbacks may take locks of their own that are held while calling Get()
+  auto callbacks = std::exchange(gEnableCallbacks, {});
+  locker.unlock();
+  for (auto &callback: callbacks) { callback(eventRing); }
+  return eventRing;
+}
+
+// _____________________________________________________________________________________________________________________
+void EventRing::OnEnable(std::function<void(EventRing *)> callback) {
+  std::unique_lock locker(gEnableMutex);
+  auto *current = gEventRing.load(std::memory_order_acquire);
+  if (current == nullptr) {
+    gEnableCallbacks.push_back(std::move(callback));
+    return;
+  }
+  locker.unlock();
+  callback(current);
+}
+
+// _____________________________________________________________________________________________________________________
+EventRing::~EventRing() {
+  munmap(_header, _size);
+  ::unlink(_path.c_str());
+}
+
+// _____________________________________________________________________________________________________________________
+uint32_t EventRing::NameId(const std::string &clock, const std::string &name) {
+  std::string scope = clock + ":" + name;
+  std::unique_lock locker(_namesMutex);
+  if (auto it = _nameIds.find(scope); it != _nameIds.end()) { return it->second; }
+  uint32_t id = _header->names.load(std::memory_order_relaxed);
+  if (id >= _header->maxNames) { return ring::kNoName; }
+  char *entry = reinterpret_cast<char *>(_header) + ring::NamesOffset() + id * ring::kNameLength;
+  std::strncpy(entry, scope.c_str(), ring::kNameLength - 1);
+  _header->names.store(id + 1, std::memory_order_release);
+  _nameIds[scope] = id;
+  return id;
+}
+
+// _____________________________________________________________________________________________________________________
+void EventRing::Publish(uint32_t nameId, uint64_t duration_ns) {
+  thread_local ThreadRing threadRing;
+  // a thread that did not get a ring tries again once an exited thread has released one
+  if (threadRing.header == nullptr &&
+      (!threadRing.claimed || _freeRingCount.load(std::memory_order_relaxed) > 0)) {
+    threadRing.claimed = true;
+    threadRing.header = Claim(threadRing.index);
+  }
+  auto *tRing = threadRing.header;
+  if (tRing == nullptr) {
+    _header->unclaimed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto *slots = reinterpret_cast<ring::Slot *>(tRing + 1);
+  // a released ring is continued at its head, so the sequence numbers keep increasing for the reader
+  uint64_t head = tRing->head.load(std::memory_order_relaxed);
+  auto &slot = slots[head & (_header->capacity - 1)];
+  // invalidate the slot before overwriting it, so a concurrent reader discards what it read
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  slot.nameId.store(nameId, std::memory_order_relaxed);
+  slot.end_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), std::memory_order_relaxed);
+  slot.duration_ns.store(duration_ns, std::memory_order_relaxed);
+  slot.seq.store(head + 1, std::memory_order_release);
+  tRing->head.store(head + 1, std::memory_order_release);
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+EventRing::EventRing(std::string path, uint32_t maxThreads, uint32_t capacity, uint32_t maxNames)
+    : _path(std::move(path)), _size(ring::FileSize(maxThreads, capacity, maxNames)) {
+  int fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(_size)) != 0) {
+    std::string error = std::strerror(errno);
+    if (fd >= 0) { ::close(fd); }
+    throw std::runtime_error("Creating event ring '" + _path + "' failed: " + error);
+  }
+  void *ptr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error("Mapping event ring '" + _path + "' failed: " + std::strerror(errno));
+  }
+  // the file is zero filled, so all counters and slots start out empty
+  _header = static_cast<ring::FileHeader *>(ptr);
+  _header->pid = ::getpid();
+  _header->maxThreads = maxThreads;
+  _header->capacity = capacity;
+  _header->maxNames = maxNames;
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(_header->magic, ring::kMagic, sizeof(ring::kMagic));
+}
+
+// _____________________________________________________________________________________________________________________
+ring::RingHeader *EventRing::Claim(uint32_t &index) {
+  {
+    std::unique_lock locker(_ringsMutex);
+    if (!_freeRings.empty()) {
+      index = _freeRings.back();
+      _freeRings.pop_back();
+      _freeRingCount.store(_freeRings.size(), std::memory_order_relaxed);
+      return Ring(index);
+    }
+  }
+  // rings are only added below maxThreads, so the reader never sees more of them
+  index = _header->threads.load(std::memory_order_relaxed);
+  do {
+    if (index >= _header->maxThreads) { return nullptr; }
+  } while (!_header->threads.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+  return Ring(index);
+}
+
+// _____________________________________________________________________________________________________________________
+void EventRing::Release(uint32_t index) {
+  std::unique_lock locker(_ringsMutex);
+  _freeRings.push_back(index);
+  _freeRingCount.store(_freeRings.size(), std::memory_order_relaxed);
+}
+
+// _____________________________________________________________________________________________________________________
+ring::RingHeader *EventRing::Ring(uint32_t index) const {
+  return reinterpret_cast<ring::RingHeader *>(reinterpret_cast<char *>(_header) + ring::RingOffset(*_header, index));
+}
+
+// ===== EventRingReader ===============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+EventRingReader::EventRingReader(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st{};
+  if (fd < 0 || ::fstat(fd, &st) != 0) {
+    std::string error = std::strerror(errno);
+    if (fd >= 0) { ::close(fd); }
+    throw std::runtime_error("Opening event ring '" + path + "' failed: " + error);
+  }
+  _size = static_cast<std::size_t>(st.st_size);
+  void *ptr = _size >= sizeof(ring::FileHeader) ? mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error("'" + path + "' is not an event ring.");
+  }
+  _header = static_cast<const ring::FileHeader *>(ptr);
+  if (std::memcmp(_header->magic, ring::kMagic, sizeof(ring::kMagic)) != 0 ||
+      _size < ring::FileSize(_header->maxThreads, _header->capacity, _header->maxNames)) {
+    munmap(ptr, _size);
+    throw std::runtime_error("'" + path + "' is not an event ring.");
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+EventRingReader::~EventRingReader() {
+  munmap(const_cast<ring::FileHeader *>(_header), _size);
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<RingEvent> EventRingReader::Poll() {
+  std::vector<RingEvent> events;
+  uint32_t threads = std::min(_header->threads.load(std::memory_order_acquire), _header->maxThreads);
+  _positions.resize(std::max<std::size_t>(_positions.size(), threads), 0);
+  uint64_t capacity = _header->capacity;
+  for (uint32_t r = 0; r < threads; ++r) {
+    const auto *ringHeader = reinterpret_cast<const ring::RingHeader *>(
+        reinterpret_cast<const char *>(_header) + ring::RingOffset(*_header, r));
+    const auto *slots = reinterpret_cast<const ring::Slot *>(ringHeader + 1);
+    uint64_t head = ringHeader->head.load(std::memory_order_acquire);
+    uint64_t &position = _positions[r];
+    if (head - position > capacity) {
+      _dropped += head - capacity - position;
+      position = head - capacity;
+    }
+    for (; position < head; ++position) {
+      const auto &slot = slots[position & (capacity - 1)];
+      uint64_t seq = slot.seq.load(std::memory_order_acquire);
+      RingEvent event;
+      event.nameId = static_cast<uint32_t>(slot.nameId.load(std::memory_order_relaxed));
+      event.end_ns = slot.end_ns.load(std::memory_order_relaxed);
+      event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // overwritten by the producer before or while it was read
+      if (seq != position + 1 || slot.seq.load(std::memory_order_relaxed) != seq) {
+        ++_dropped;
+        continue;
+      }
+      events.push_back(event);
+    }
+  }
+  return events;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string EventRingReader::Name(uint32_t nameId) const {
+  if (nameId >= _header->names.load(std::memory_order_acquire)) { return "?"; }
+  const char *entry = reinterpret_cast<const char *>(_header) + ring::NamesOffset() + nameId * ring::kNameLength;
+  return {entry, strnlen(entry, ring::kNameLength)};
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,194 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "benchmarked/exporter.h"
+#include "benchmarked/benchmark.h"
+
+namespace benchmarked {
+
+namespace {
+
+// the bucket bounds are powers of two minus one ns: the values up to and including them are exactly the ones below a
+//  bucket boundary of LatencyHistogram, so the cumulative counts are exact. ~1 us to ~17 s.
+constexpr unsigned kFirstBoundExponent = 10;
+constexpr unsigned kLastBoundExponent = 34;
+
+// _____________________________________________________________________________________________________________________
+std::string EscapeLabel(const std::string &value) {
+  std::string escaped;
+  for (char c: value) {
+    switch (c) {
+      case '\\': escaped += "\\\\"; break;
+      case '"': escaped += "\\\""; break;
+      case '\n': escaped += "\\n"; break;
+      default: escaped += c;
+    }
+  }
+  return escaped;
+}
+
+}  // namespace
+
+// ===== MetricsExporter ===============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+MetricsExporter::MetricsExporter(std::string target, std::chrono::milliseconds interval)
+    : _target(std::move(target)), _interval(interval) {
+  // the handler is created before and therefore destroyed after this exporter, whose destructor collects once more
+  CodeBenchmarkHandler::GetInstance();
+  if (_target.rfind("unix:", 0) == 0) {
+    _socketPath = _target.substr(5);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (_socketPath.empty() || _socketPath.size() >= sizeof(address.sun_path)) {
+      throw std::runtime_error("Invalid metrics socket path '" + _socketPath + "'.");
+    }
+    std::strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path) - 1);
+    _listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    ::unlink(_socketPath.c_str());
+    if (_listenFd < 0 || ::bind(_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(_listenFd, 16) != 0) {
+      std::string error = std::strerror(errno);
+      if (_listenFd >= 0) { ::close(_listenFd); }
+      throw std::runtime_error("Listening on metrics socket '" + _socketPath + "' failed: " + error);
+    }
+  }
+  if (::pipe2(_wakeFds, O_CLOEXEC) != 0) {
+    if (_listenFd >= 0) { ::close(_listenFd); }
+    throw std::runtime_error(std::string("Creating metrics exporter failed: ") + std::strerror(errno));
+  }
+  _thread = std::thread(&MetricsExporter::Loop, this);
+}
+
+// _____________________________________________________________________________________________________________________
+MetricsExporter::~MetricsExporter() {
+  char stop = 0;
+  [[maybe_unused]] auto written = ::write(_wakeFds[1], &stop, 1);
+  _thread.join();
+  ::close(_wakeFds[0]);
+  ::close(_wakeFds[1]);
+  if (_listenFd >= 0) {
+    ::close(_listenFd);
+    ::unlink(_socketPath.c_str());
+  } else {
+    // the file keeps the state at shutdown
+    Publish(Collect());
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+std::string MetricsExporter::Collect() {
+  auto snapshots = CodeBenchmarkHandler::GetInstance().Snapshot();
+  std::unique_lock locker(_mutex);
+  std::stringstream histograms, calls, means, p50s, p99s, maxima;
+  auto header = [](std::stringstream &stream, const std::string &name, const std::string &type,
+                   const std::string &help) {
+    stream << std::setprecision(12) << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+  };
+  header(histograms, "benchmarked_scope_duration_seconds", "histogram",
+         "Duration of the intervals of instrumented code scopes.");
+  header(calls, "benchmarked_scope_window_calls", "gauge", "Intervals closed during the last export window.");
+  header(means, "benchmarked_scope_window_mean_seconds", "gauge", "Mean duration during the last export window.");
+  header(p50s, "benchmarked_scope_window_p50_seconds", "gauge", "Median duration during the last export window.");
+  header(p99s, "benchmarked_scope_window_p99_seconds", "gauge", "99th percentile during the last export window.");
+  header(maxima, "benchmarked_scope_window_max_seconds", "gauge", "Maximum duration during the last export window.");
+
+  for (const auto &snapshot: snapshots) {
+    std::string labels = "scope=\"" + EscapeLabel(snapshot.name) + "\",clock=\"" + snapshot.clock + "\"";
+    const auto &histogram = snapshot.histogram;
+    for (unsigned exponent = kFirstBoundExponent; exponent <= kLastBoundExponent; exponent += 2) {
+      uint64_t bound_ns = (uint64_t(1) << exponent) - 1;
+      histograms << "benchmarked_scope_duration_seconds_bucket{" << labels << ",le=\""
+                 << static_cast<double>(bound_ns) / 1e9 << "\"} " << histogram.CountAtMost(bound_ns) << "\n";
+    }
+    histograms << "benchmarked_scope_duration_seconds_bucket{" << labels << ",le=\"+Inf\"} " << histogram.Count()
+               << "\n"
+               << "benchmarked_scope_duration_seconds_sum{" << labels << "} " << histogram.Sum() / 1e9 << "\n"
+               << "benchmarked_scope_duration_seconds_count{" << labels << "} " << histogram.Count() << "\n";
+
+    auto &previous = _previous[snapshot.clock + '\0' + snapshot.name];
+    auto window = histogram.Since(previous);
+    previous = histogram;
+    calls << "benchmarked_scope_window_calls{" << labels << "} " << window.Count() << "\n";
+    means << "benchmarked_scope_window_mean_seconds{" << labels << "} " << window.Mean() / 1e9 << "\n";
+    p50s << "benchmarked_scope_window_p50_seconds{" << labels << "} " << window.Percentile(50) / 1e9 << "\n";
+    p99s << "benchmarked_scope_window_p99_seconds{" << labels << "} " << window.Percentile(99) / 1e9 << "\n";
+    maxima << "benchmarked_scope_window_max_seconds{" << labels << "} " << static_cast<double>(window.Max()) / 1e9
+           << "\n";
+  }
+  return histograms.str() + calls.str() + means.str() + p50s.str() + p99s.str() + maxima.str();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void MetricsExporter::Loop() {
+  auto next = std::chrono::steady_clock::now();
+  while (true) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next) {
+      Publish(Collect());
+      next = now + _interval;
+    }
+    pollfd fds[2] = {{_wakeFds[0], POLLIN, 0}, {_listenFd, POLLIN, 0}};
+    auto timeout_ms = std::chrono::ceil<std::chrono::milliseconds>(next - now).count();
+    int ready = ::poll(fds, _listenFd >= 0 ? 2 : 1, static_cast<int>(timeout_ms));
+    if (ready < 0 && errno != EINTR) { return; }
+    if (ready <= 0) { continue; }
+    if (fds[0].revents != 0) { return; }
+    if (fds[1].revents & POLLIN) { Serve(); }
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void MetricsExporter::Publish(const std::string &exposition) {
+  {
+    std::unique_lock locker(_mutex);
+    _exposition = exposition;
+  }
+  if (_listenFd >= 0) { return; }
+  // rename() is atomic, so readers never see a partially written file
+  std::string tmpPath = _target + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::trunc);
+    file << exposition;
+    if (!file) { return; }
+  }
+  std::rename(tmpPath.c_str(), _target.c_str());
+}
+
+// _____________________________________________________________________________________________________________________
+void MetricsExporter::Serve() {
+  int client;
+  while ((client = ::accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+    // a stalled client must not block the exporter
+    timeval timeout{1, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    std::string exposition;
+    {
+      std::unique_lock locker(_mutex);
+      exposition = _exposition;
+    }
+    std::size_t sent = 0;
+    while (sent < exposition.size()) {
+      auto n = ::send(client, exposition.data() + sent, exposition.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) { break; }
+      sent += static_cast<std::size_t>(n);
+    }
+    ::close(client);
+  }
+}
+
+}  // namespace benchmarked
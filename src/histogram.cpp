@@ -0,0 +1,117 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "benchmarked/histogram.h"
+
+namespace benchmarked {
+
+// ===== LatencyHistogram ==============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void LatencyHistogram::Record(uint64_t value_ns) {
+  ++_buckets[BucketIndex(value_ns)];
+  ++_count;
+  _sum += static_cast<double>(value_ns);
+  _min = std::min(_min, value_ns);
+  _max = std::max(_max, value_ns);
+}
+
+// _____________________________________________________________________________________________________________________
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  for (std::size_t i = 0; i < kBuckets; ++i) { _buckets[i] += other._buckets[i]; }
+  _count += other._count;
+  _sum += other._sum;
+  _min = std::min(_min, other._min);
+  _max = std::max(_max, other._max);
+}
+
+// _____________________________________________________________________________________________________________________
+double LatencyHistogram::Percentile(double p) const {
+  if (_count == 0) { return 0; }
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100 * static_cast<double>(_count)));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += _buckets[i];
+    if (seen >= rank) {
+      double lower = static_cast<double>(BucketLowerBound(i));
+      double upper = i + 1 < kBuckets ? static_cast<double>(BucketLowerBound(i + 1)) : lower;
+      return std::clamp((lower + upper - 1) / 2, static_cast<double>(_min), static_cast<double>(_max));
+    }
+  }
+  return static_cast<double>(_max);
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t LatencyHistogram::CountBelow(uint64_t bound_ns) const {
+  uint64_t count = 0;
+  for (std::size_t i = 0; i + 1 < kBuckets && BucketLowerBound(i + 1) <= bound_ns; ++i) {
+    count += _buckets[i];
+  }
+  return count;
+}
+
+// _____________________________________________________________________________________________________________________
+LatencyHistogram LatencyHistogram::Since(const LatencyHistogram &earlier) const {
+  LatencyHistogram window;
+  window._count = _count - earlier._count;
+  window._sum = _sum - earlier._sum;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    window._buckets[i] = _buckets[i] - earlier._buckets[i];
+    if (window._buckets[i] == 0) { continue; }
+    window._min = std::min(window._min, std::max(BucketLowerBound(i), _min));
+    uint64_t upper = i + 1 < kBuckets ? BucketLowerBound(i + 1) - 1 : UINT64_MAX;
+    window._max = std::min(upper, _max);
+  }
+  return window;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::size_t LatencyHistogram::BucketIndex(uint64_t value_ns) {
+  if (value_ns < kSubBuckets) { return value_ns; }
+  // the kSubBucketBits bits below the most significant one select the linear bucket within the power of two
+  unsigned msb = 63 - std::countl_zero(value_ns);
+  unsigned shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((value_ns >> shift) - kSubBuckets);
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t LatencyHistogram::BucketLowerBound(std::size_t index) {
+  if (index < kSubBuckets) { return index; }
+  std::size_t shift = index / kSubBuckets - 1;
+  return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+// ===== ConcurrentLatencyHistogram ====================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void ConcurrentLatencyHistogram::Record(uint64_t value_ns) {
+  _buckets[LatencyHistogram::BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  _count.fetch_add(1, std::memory_order_relaxed);
+  _sum.fetch_add(value_ns, std::memory_order_relaxed);
+  // the extremes are rarely updated, so the CAS loops are mostly skipped after the first load
+  uint64_t current = _min.load(std::memory_order_relaxed);
+  while (value_ns < current && !_min.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {}
+  current = _max.load(std::memory_order_relaxed);
+  while (value_ns > current && !_max.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {}
+}
+
+// _____________________________________________________________________________________________________________________
+LatencyHistogram ConcurrentLatencyHistogram::Snapshot() const {
+  LatencyHistogram snapshot;
+  for (std::size_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+    snapshot._buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    snapshot._count += snapshot._buckets[i];
+  }
+  snapshot._sum = static_cast<double>(_sum.load(std::memory_order_relaxed));
+  snapshot._min = _min.load(std::memory_order_relaxed);
+  snapshot._max = _max.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+}  // namespace benchmarked
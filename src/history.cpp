@@ -0,0 +1,247 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "benchmarked/history.h"
+
+namespace benchmarked {
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'M', 'H', 'I', 'S', 'T', '0', '1'};
+constexpr std::size_t HEADER_SIZE = sizeof(MAGIC);
+
+// on-disk layout of a HistoryRecord
+struct DiskRecord {
+  int64_t timestamp;
+  uint64_t iterations;
+  double wallMin_ns;
+  double wallMean_ns;
+  double wallMedian_ns;
+  double cpuMedian_ns;
+  char gitSha[48];
+  char name[128];
+};
+
+static_assert(sizeof(DiskRecord) == 224, "history file layout changed");
+
+// _____________________________________________________________________________________________________________________
+double median(std::vector<double> values) {
+  if (values.empty()) { return 0; }
+  auto mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+
+// _____________________________________________________________________________________________________________________
+void segment(const std::vector<double> &values, std::size_t begin, std::size_t end, double sigma, double threshold,
+             double minChange, std::vector<std::size_t> &splits) {
+  constexpr std::size_t MIN_SEGMENT = 3;
+  if (end - begin < 2 * MIN_SEGMENT) { return; }
+  // prefix sums make every candidate split O(1)
+  std::vector<double> prefix(end - begin + 1, 0);
+  for (std::size_t i = begin; i < end; ++i) { prefix[i - begin + 1] = prefix[i - begin] + values[i]; }
+  double n = static_cast<double>(end - begin);
+  double best = 0;
+  std::size_t bestSplit = 0;
+  for (std::size_t k = MIN_SEGMENT; k <= end - begin - MIN_SEGMENT; ++k) {
+    double n1 = static_cast<double>(k);
+    double n2 = n - n1;
+    double mean1 = prefix[k] / n1;
+    double mean2 = (prefix.back() - prefix[k]) / n2;
+    double statistic = std::abs(mean2 - mean1) * std::sqrt(n1 * n2 / n) / sigma;
+    if (statistic > best && std::abs(mean2 - mean1) >= minChange * std::abs(mean1)) {
+      best = statistic;
+      bestSplit = k;
+    }
+  }
+  if (best < threshold) { return; }
+  segment(values, begin, begin + bestSplit, sigma, threshold, minChange, splits);
+  splits.push_back(begin + bestSplit);
+  segment(values, begin + bestSplit, end, sigma, threshold, minChange, splits);
+}
+
+}  // namespace
+
+// ===== HistoryStore ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+HistoryStore::HistoryStore(const std::string &path, bool readOnly) : _path(path), _readOnly(readOnly) {
+  _fd = open(path.c_str(), readOnly ? O_RDONLY : O_RDWR | O_APPEND | O_CREAT, 0644);
+  if (_fd < 0) {
+    throw std::runtime_error("Opening history store '" + path + "' failed: " + std::strerror(errno));
+  }
+  // the header is written and a partial record is cut off by one process at a time, appends wait for it
+  if (!readOnly) { flock(_fd, LOCK_EX); }
+  struct stat st{};
+  fstat(_fd, &st);
+  auto size = static_cast<std::size_t>(st.st_size);
+  bool valid = true;
+  if (size == 0 && !readOnly) {
+    valid = write(_fd, MAGIC, HEADER_SIZE) == static_cast<ssize_t>(HEADER_SIZE);
+  } else if (size > 0) {
+    char magic[HEADER_SIZE];
+    valid = pread(_fd, magic, HEADER_SIZE, 0) == static_cast<ssize_t>(HEADER_SIZE) &&
+            std::memcmp(magic, MAGIC, HEADER_SIZE) == 0;
+    // a record cut off by a crash would shift every record appended after it
+    std::size_t complete = HEADER_SIZE + (size - std::min(size, HEADER_SIZE)) / sizeof(DiskRecord) * sizeof(DiskRecord);
+    if (valid && !readOnly && complete != size) { valid = ftruncate(_fd, static_cast<off_t>(complete)) == 0; }
+  }
+  if (!readOnly) { flock(_fd, LOCK_UN); }
+  if (!valid) {
+    close(_fd);
+    throw std::runtime_error("'" + path + "' is not a benchmarked history store.");
+  }
+  Refresh();
+}
+
+// _____________________________________________________________________________________________________________________
+HistoryStore::~HistoryStore() {
+  if (_data != nullptr) { munmap(const_cast<char *>(_data), _mappedSize); }
+  if (_fd >= 0) { close(_fd); }
+}
+
+// _____________________________________________________________________________________________________________________
+void HistoryStore::Append(const HistoryRecord &record) {
+  DiskRecord disk{};
+  disk.timestamp = record.timestamp;
+  disk.iterations = record.iterations;
+  disk.wallMin_ns = record.wallMin_ns;
+  disk.wallMean_ns = record.wallMean_ns;
+  disk.wallMedian_ns = record.wallMedian_ns;
+  disk.cpuMedian_ns = record.cpuMedian_ns;
+  std::strncpy(disk.gitSha, record.gitSha.c_str(), sizeof(disk.gitSha) - 1);
+  std::strncpy(disk.name, record.name.c_str(), sizeof(disk.name) - 1);
+  if (_readOnly) {
+    throw std::runtime_error("Appending to history store '" + _path + "' failed: opened read-only.");
+  }
+  flock(_fd, LOCK_SH);
+  bool written = write(_fd, &disk, sizeof(disk)) == static_cast<ssize_t>(sizeof(disk));
+  int error = errno;
+  flock(_fd, LOCK_UN);
+  if (!written) {
+    throw std::runtime_error("Appending to history store '" + _path + "' failed: " + std::strerror(error));
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::string> HistoryStore::Names() {
+  Refresh();
+  std::vector<std::string> names;
+  for (const auto &[name, indices]: _index) { names.push_back(name); }
+  return names;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<HistoryRecord> HistoryStore::Query(const std::string &name, int64_t from, int64_t to) {
+  Refresh();
+  std::vector<HistoryRecord> records;
+  auto it = _index.find(name);
+  if (it == _index.end()) { return records; }
+  for (auto index: it->second) {
+    auto record = Read(index);
+    if (record.timestamp >= from && record.timestamp <= to) { records.push_back(std::move(record)); }
+  }
+  return records;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void HistoryStore::Refresh() {
+  struct stat st{};
+  fstat(_fd, &st);
+  auto size = static_cast<std::size_t>(st.st_size);
+  if (size < HEADER_SIZE) { return; }
+  // ignore a partially written record at the end
+  std::size_t records = (size - HEADER_SIZE) / sizeof(DiskRecord);
+  if (records == _indexedRecords) { return; }
+
+  if (_data != nullptr) { munmap(const_cast<char *>(_data), _mappedSize); }
+  void *ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, _fd, 0);
+  if (ptr == MAP_FAILED) {
+    _data = nullptr;
+    throw std::runtime_error("Mapping history store '" + _path + "' failed: " + std::strerror(errno));
+  }
+  _data = static_cast<const char *>(ptr);
+  _mappedSize = size;
+
+  for (std::size_t i = _indexedRecords; i < records; ++i) {
+    const auto *disk = reinterpret_cast<const DiskRecord *>(_data + HEADER_SIZE + i * sizeof(DiskRecord));
+    _index[std::string(disk->name, strnlen(disk->name, sizeof(disk->name)))].push_back(i);
+  }
+  _indexedRecords = records;
+  auto timestamp = [this](std::size_t index) {
+    return reinterpret_cast<const DiskRecord *>(_data + HEADER_SIZE + index * sizeof(DiskRecord))->timestamp;
+  };
+  for (auto &[name, indices]: _index) {
+    std::stable_sort(indices.begin(), indices.end(), [&timestamp](std::size_t a, std::size_t b) {
+      return timestamp(a) < timestamp(b);
+    });
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+HistoryRecord HistoryStore::Read(std::size_t index) const {
+  const auto *disk = reinterpret_cast<const DiskRecord *>(_data + HEADER_SIZE + index * sizeof(DiskRecord));
+  HistoryRecord record;
+  record.timestamp = disk->timestamp;
+  record.name = std::string(disk->name, strnlen(disk->name, sizeof(disk->name)));
+  record.gitSha = std::string(disk->gitSha, strnlen(disk->gitSha, sizeof(disk->gitSha)));
+  record.iterations = disk->iterations;
+  record.wallMin_ns = disk->wallMin_ns;
+  record.wallMean_ns = disk->wallMean_ns;
+  record.wallMedian_ns = disk->wallMedian_ns;
+  record.cpuMedian_ns = disk->cpuMedian_ns;
+  return record;
+}
+
+// ===== change point detection ========================================================================================
+// _____________________________________________________________________________________________________________________
+std::vector<ChangePoint> DetectChangePoints(const std::vector<HistoryRecord> &history, double threshold,
+                                            double minChange) {
+  std::vector<ChangePoint> changes;
+  if (history.size() < 2) { return changes; }
+  std::vector<double> values;
+  values.reserve(history.size());
+  for (const auto &record: history) { values.push_back(record.wallMedian_ns); }
+
+  // noise: MAD of consecutive differences, scaled to a standard deviation of single values
+  std::vector<double> differences;
+  for (std::size_t i = 1; i < values.size(); ++i) { differences.push_back(values[i] - values[i - 1]); }
+  double center = median(differences);
+  for (auto &difference: differences) { difference = std::abs(difference - center); }
+  double sigma = 1.4826 * median(differences) / std::sqrt(2.0);
+  if (sigma <= 0) { sigma = std::max(1e-9, 1e-3 * std::abs(median(values))); }
+
+  std::vector<std::size_t> splits;
+  segment(values, 0, values.size(), sigma, threshold, minChange, splits);
+
+  std::size_t begin = 0;
+  for (std::size_t s = 0; s < splits.size(); ++s) {
+    std::size_t split = splits[s];
+    std::size_t end = s + 1 < splits.size() ? splits[s + 1] : values.size();
+    ChangePoint change;
+    change.index = split;
+    change.timestamp = history[split].timestamp;
+    change.gitSha = history[split].gitSha;
+    change.before_ns = median(std::vector<double>(values.begin() + begin, values.begin() + split));
+    change.after_ns = median(std::vector<double>(values.begin() + split, values.begin() + end));
+    changes.push_back(std::move(change));
+    begin = split;
+  }
+  return changes;
+}
+
+}  // namespace benchmarked
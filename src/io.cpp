@@ -0,0 +1,118 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "benchmarked/io.h"
+
+namespace benchmarked {
+
+// ===== IOCounters ====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::optional<IOCounters> IOCounters::Read() {
+  std::ifstream file("/proc/self/io");
+  if (!file) { return std::nullopt; }
+  return Parse(file);
+}
+
+// _____________________________________________________________________________________________________________________
+IOCounters IOCounters::Parse(std::istream &stream) {
+  IOCounters counters;
+  std::string name;
+  uint64_t value;
+  while (stream >> name >> value) {
+    if (name == "rchar:") { counters.rchar = value; }
+    if (name == "wchar:") { counters.wchar = value; }
+    if (name == "syscr:") { counters.syscr = value; }
+    if (name == "syscw:") { counters.syscw = value; }
+    if (name == "read_bytes:") { counters.readBytes = value; }
+    if (name == "write_bytes:") { counters.writeBytes = value; }
+    if (name == "cancelled_write_bytes:") { counters.cancelledWriteBytes = value; }
+  }
+  return counters;
+}
+
+// _____________________________________________________________________________________________________________________
+const IOCounters &IOCounters::ReadOverhead() {
+  static const IOCounters overhead = []() {
+    auto first = Read();
+    auto second = Read();
+    return first && second ? *second - *first : IOCounters();
+  }();
+  return overhead;
+}
+
+// _____________________________________________________________________________________________________________________
+IOCounters IOCounters::operator-(const IOCounters &other) const {
+  auto minus = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+  IOCounters delta;
+  delta.rchar = minus(rchar, other.rchar);
+  delta.wchar = minus(wchar, other.wchar);
+  delta.syscr = minus(syscr, other.syscr);
+  delta.syscw = minus(syscw, other.syscw);
+  delta.readBytes = minus(readBytes, other.readBytes);
+  delta.writeBytes = minus(writeBytes, other.writeBytes);
+  delta.cancelledWriteBytes = minus(cancelledWriteBytes, other.cancelledWriteBytes);
+  return delta;
+}
+
+// _____________________________________________________________________________________________________________________
+IOCounters &IOCounters::operator+=(const IOCounters &other) {
+  rchar += other.rchar;
+  wchar += other.wchar;
+  syscr += other.syscr;
+  syscw += other.syscw;
+  readBytes += other.readBytes;
+  writeBytes += other.writeBytes;
+  cancelledWriteBytes += other.cancelledWriteBytes;
+  return *this;
+}
+
+// ===== page cache ====================================================================================================
+// _____________________________________________________________________________________________________________________
+int OpenDirect(const std::string &path, int flags, mode_t mode) {
+#if defined(O_DIRECT)
+  int fd = ::open(path.c_str(), flags | O_DIRECT | O_CLOEXEC, mode);
+  if (fd < 0) {
+    throw std::runtime_error("Opening '" + path + "' with O_DIRECT failed: " + std::strerror(errno));
+  }
+  return fd;
+#else
+  throw std::runtime_error("Opening '" + path + "' with O_DIRECT failed: not supported on this platform.");
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void EvictPageCache(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Opening '" + path + "' failed: " + std::strerror(errno));
+  }
+  try {
+    EvictPageCache(fd);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+// _____________________________________________________________________________________________________________________
+void EvictPageCache(int fd) {
+  // dirty pages are not dropped, write them back first
+  if (::fdatasync(fd) != 0 && errno != EINVAL) {
+    throw std::runtime_error(std::string("Writing back a file failed: ") + std::strerror(errno));
+  }
+  int error = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  if (error != 0) {
+    throw std::runtime_error(std::string("Evicting a file from the page cache failed: ") + std::strerror(error));
+  }
+}
+
+}  // namespace benchmarked
@@ -1,13 +1,50 @@
 // Copyright Leon Freist
 // Author Leon Freist <freist@informatik.uni-freiburg.de>
 
+#include <algorithm>
 #include <regex>
 #include <fstream>
+#include <filesystem>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
 
+#include <boost/program_options.hpp>
+
+#include "benchmarked/calibration.h"
+#include "benchmarked/history.h"
 #include "benchmarked/launcher.h"
+#include "benchmarked/watchdog.h"
 
 namespace benchmarked {
 
+namespace {
+
+// _____________________________________________________________________________________________________________________
+std::map<std::string, double> runtimeEstimates(const std::string &historyFile) {
+  std::map<std::string, double> estimates;
+  if (historyFile.empty() || !std::filesystem::exists(historyFile)) { return estimates; }
+  HistoryStore store(historyFile, true);
+  for (const auto &name: store.Names()) {
+    // the most recent run, so that the estimate follows changes of the benchmark
+    auto history = store.Query(name);
+    if (history.empty()) { continue; }
+    estimates[name] = history.back().wallMean_ns * static_cast<double>(history.back().iterations);
+  }
+  return estimates;
+}
+
+// _____________________________________________________________________________________________________________________
+void validateOptions(const std::string &name, const BenchmarkOptions &options) {
+  if (options.openLoopRate > 0 && options.coldCache) {
+    throw std::invalid_argument("Benchmark '" + name + "': open-loop mode can not be combined with coldCache.");
+  }
+}
+
+}  // namespace
+
 // ===== Launcher ======================================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
@@ -17,20 +54,81 @@ Launcher::Launcher(const std::string &name) {
 
 // _____________________________________________________________________________________________________________________
 void Launcher::Launch(const std::string& nameFilter, const std::string& typeFilter) {
-  for (const auto &builder: _builders) {
-    RegisterBenchmark(builder());
-  }
+  BuildBenchmarks();
 
   std::regex nameMatcher(nameFilter);
+  std::vector<std::shared_ptr<BenchmarkBase>> selected;
   for (const auto &bm: _benchmarks) {
     if ((nameFilter.empty() || std::regex_match(bm->_name, nameMatcher)) && (typeFilter.empty() || typeFilter == bm->_type)) {
-      bm->Launch();
+      selected.push_back(bm);
+    }
+  }
+  if (_shardCount > 1) { selected = SelectShard(selected); }
+  if (!_completed.empty()) {
+    std::vector<std::shared_ptr<BenchmarkBase>> remaining;
+    for (const auto &bm: selected) {
+      auto it = _completed.find({bm->_name, bm->_type});
+      if (it == _completed.end()) {
+        remaining.push_back(bm);
+      } else {
+        std::replace(_benchmarks.begin(), _benchmarks.end(), bm, it->second);
+      }
+    }
+    std::cerr << "Resuming from checkpoint '" << _checkpoint->Path() << "': " << selected.size() - remaining.size()
+              << " of " << selected.size() << " benchmarks already completed." << std::endl;
+    selected = std::move(remaining);
+  }
+
+  // the header of the checkpoint holds the host profile, it must not be calibrated on the watchdog thread either
+  if (_checkpoint) { HostProfile::Get(); }
+
+  using Clock = Watchdog::Clock;
+  _queue = selected;
+  Watchdog watchdog([this]() { OnTimeout(); });
+  auto suiteDeadline = _timeBudget.count() > 0 ? Clock::now() + _timeBudget : Clock::time_point::max();
+  for (std::size_t i = 0; i < selected.size(); ++i) {
+    auto &bm = selected[i];
+    _queuePosition = i;
+    auto now = Clock::now();
+    if (now >= suiteDeadline) {
+      bm->_timedOut = true;
+      bm->_launched = true;
+      continue;
+    }
+    auto deadline = Clock::time_point::max();
+    if (bm->_options.benchmarkTimeout.count() > 0) {
+      deadline = now + bm->_options.benchmarkTimeout;
+    }
+    if (suiteDeadline != Clock::time_point::max()) {
+      deadline = std::min(deadline, now + (suiteDeadline - now) / static_cast<long>(selected.size() - i));
+    }
+    bm->_deadline = deadline;
+    // the running iteration may overrun the deadline by the time the benchmark was given before it is killed
+    bm->_hardDeadline = deadline == Clock::time_point::max() ? deadline : deadline + (deadline - now);
+    bm->_watchdog = &watchdog;
+    _running = bm.get();
+    bm->Launch();
+    _running = nullptr;
+    bm->_watchdog = nullptr;
+    if (_checkpoint) {
+      std::unique_lock lock(_checkpointMutex);
+      _checkpoint->Append(*bm);
     }
   }
+  _queue.clear();
+}
+
+// _____________________________________________________________________________________________________________________
+void Launcher::BuildBenchmarks() {
+  for (const auto &builder: _builders) {
+    RegisterBenchmark(builder());
+  }
+  _builders.clear();
 }
 
 // _____________________________________________________________________________________________________________________
 void Launcher::RegisterBenchmark(const std::shared_ptr<BenchmarkBase> &benchmark) {
+  validateOptions(benchmark->_name, benchmark->_options);
   _benchmarks.emplace_back(benchmark);
 }
 
@@ -51,6 +149,30 @@ void Launcher::ClearAllBenchmarksBuilders() {
   _builders.clear();
 }
 
+// _____________________________________________________________________________________________________________________
+void Launcher::SetTimeBudget(std::chrono::milliseconds budget) {
+  _timeBudget = budget;
+}
+
+// _____________________________________________________________________________________________________________________
+void Launcher::SetShard(unsigned index, unsigned count, std::map<std::string, double> runtimeEstimates_ns) {
+  if (count == 0 || index >= count) {
+    throw std::invalid_argument("Invalid shard " + std::to_string(index) + " of " + std::to_string(count) + ".");
+  }
+  _shardIndex = index;
+  _shardCount = count;
+  _runtimeEstimates_ns = std::move(runtimeEstimates_ns);
+}
+
+// _____________________________________________________________________________________________________________________
+void Launcher::SetCheckpoint(const std::string &path, bool resume) {
+  _completed.clear();
+  if (resume) {
+    for (auto &bm: Checkpoint::Load(path)) { _completed[{bm->_name, bm->_type}] = bm; }
+  }
+  _checkpoint = std::make_unique<Checkpoint>(path, !resume);
+}
+
 // _____________________________________________________________________________________________________________________
 void Launcher::Report(std::unique_ptr<Reporter> reporter) {
   reporter->ReportInit(_name);
@@ -61,6 +183,84 @@ void Launcher::Report(std::unique_ptr<Reporter> reporter) {
   }
 }
 
+// _____________________________________________________________________________________________________________________
+void Launcher::Compare(std::unique_ptr<CompareReporter> reporter) {
+  reporter->Report(_benchmarks);
+}
+
+// ----- protected -----------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::vector<std::shared_ptr<BenchmarkBase>> Launcher::SelectShard(
+    const std::vector<std::shared_ptr<BenchmarkBase>> &benchmarks) const {
+  // benchmarks without an estimate are assumed to take the median time of the ones with an estimate
+  std::vector<double> known;
+  for (const auto &bm: benchmarks) {
+    if (auto it = _runtimeEstimates_ns.find(bm->_name); it != _runtimeEstimates_ns.end()) {
+      known.push_back(it->second);
+    }
+  }
+  double fallback = 1;
+  if (!known.empty()) {
+    auto mid = known.begin() + static_cast<std::ptrdiff_t>(known.size() / 2);
+    std::nth_element(known.begin(), mid, known.end());
+    fallback = *mid;
+  }
+  std::vector<std::pair<double, std::size_t>> order;
+  for (std::size_t i = 0; i < benchmarks.size(); ++i) {
+    auto it = _runtimeEstimates_ns.find(benchmarks[i]->_name);
+    order.emplace_back(it != _runtimeEstimates_ns.end() ? it->second : fallback, i);
+  }
+  std::stable_sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+  // longest first, each to the shard with the least estimated time so far (the lowest one on ties): without
+  //  estimates this is round robin in registration order
+  std::vector<double> shardTimes(_shardCount, 0);
+  std::vector<bool> selected(benchmarks.size(), false);
+  for (const auto &[estimate, i]: order) {
+    auto shard = std::min_element(shardTimes.begin(), shardTimes.end()) - shardTimes.begin();
+    shardTimes[shard] += estimate;
+    selected[i] = static_cast<unsigned>(shard) == _shardIndex;
+  }
+  std::vector<std::shared_ptr<BenchmarkBase>> shard;
+  for (std::size_t i = 0; i < benchmarks.size(); ++i) {
+    if (selected[i]) { shard.push_back(benchmarks[i]); }
+  }
+  return shard;
+}
+
+// _____________________________________________________________________________________________________________________
+void Launcher::OnTimeout() {
+  BenchmarkBase *bm = _running.load();
+  if (bm != nullptr) {
+    // the iteration is still running in the launching thread: everything below only reads a copy of the results
+    auto snapshot = std::make_shared<RecordedBenchmark>(*bm);
+    snapshot->_timedOut = true;
+    snapshot->_launched = true;
+    std::replace_if(_benchmarks.begin(), _benchmarks.end(), [bm](const auto &b) { return b.get() == bm; }, snapshot);
+    std::cerr << "Benchmark '" << bm->_name << "' exceeded its time limit, reporting the results collected so far."
+              << std::endl;
+    // recorded as timed out, so a resumed run does not get stuck in the same iteration again
+    if (_checkpoint) {
+      std::unique_lock lock(_checkpointMutex);
+      try {
+        _checkpoint->Append(*snapshot);
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+      }
+    }
+  }
+  // reported as skipped, a resumed run runs them since they are not in the checkpoint
+  for (std::size_t i = _queuePosition + 1; i < _queue.size(); ++i) {
+    _queue[i]->_skipped = true;
+    _queue[i]->_launched = true;
+  }
+  if (_timeoutHandler) {
+    _timeoutHandler();
+  }
+  // exit code of timeout(1)
+  std::_Exit(124);
+}
+
 // ===== ConsoleLauncher ===============================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
@@ -71,21 +271,97 @@ LauncherConsole &LauncherConsole::GetInstance() {
 
 // _____________________________________________________________________________________________________________________
 void LauncherConsole::Initialize(int argc, char **argv) {
-  // TODO: implement
+  namespace po = boost::program_options;
+
+  const char *historyEnv = std::getenv("BENCHMARKED_HISTORY");
+  if (historyEnv != nullptr) { _historyFile = historyEnv; }
+
+  po::options_description options("Options");
+  options.add_options()
+      ("help,h", "print this help message")
+      ("list,l", po::bool_switch(&_list), "list the benchmarks matching the filters instead of running them")
+      ("name,n", po::value<std::string>(&_nameFilter), "only run benchmarks whose name matches this regex")
+      ("type,t", po::value<std::string>(&_typeFilter), "only run benchmarks of this type")
+      ("format,f", po::value<std::string>(&_outputType)->default_value(_outputType), "report format: console, csv")
+      ("output,o", po::value<std::string>(&_outputFile), "write the report to this file instead of stdout")
+      ("metadata", po::value<std::string>(&_metadataFile),
+       "write the environment and host profile of a csv report to this file (default: <output>.meta.csv, stderr if "
+       "the report is written to stdout)")
+      ("history", po::value<std::string>(&_historyFile),
+       "append the results to this history store (default: $BENCHMARKED_HISTORY)")
+      ("time-budget", po::value<double>(),
+       "time budget in seconds for all benchmarks, shared equally by the benchmarks not run yet")
+      ("shard", po::value<std::string>(),
+       "only run shard <index>/<count> (index from 0), balanced by the runtimes in the history store")
+      ("checkpoint", po::value<std::string>(&_checkpointFile),
+       "append the results of every completed benchmark to this file")
+      ("resume", po::bool_switch(&_resume), "skip the benchmarks already in the checkpoint and report their results");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+  } catch (const po::error &e) {
+    std::cerr << e.what() << "\n" << options << std::endl;
+    std::exit(1);
+  }
+  if (vm.count("help")) {
+    std::cout << options << std::endl;
+    std::exit(0);
+  }
+  if (vm.count("time-budget")) {
+    SetTimeBudget(std::chrono::milliseconds(std::llround(vm["time-budget"].as<double>() * 1000)));
+  }
+  try {
+    if (vm.count("shard")) {
+      std::istringstream shard(vm["shard"].as<std::string>());
+      unsigned index = 0;
+      unsigned count = 0;
+      char separator = 0;
+      if (!(shard >> index >> separator >> count) || separator != '/' || !(shard >> std::ws).eof()) {
+        throw std::invalid_argument("Invalid shard '" + vm["shard"].as<std::string>() + "', expected <index>/<count>.");
+      }
+      SetShard(index, count, runtimeEstimates(_historyFile));
+    }
+    if (!_checkpointFile.empty()) {
+      SetCheckpoint(_checkpointFile, _resume);
+    } else if (_resume) {
+      throw std::invalid_argument("--resume requires --checkpoint.");
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::exit(1);
+  }
+  _timeoutHandler = [this]() { Report(); };
   _initialized = true;
 }
 
 // _____________________________________________________________________________________________________________________
 void LauncherConsole::Execute() {
+  // invalid benchmark options are rejected before any benchmark runs
+  try {
+    BuildBenchmarks();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::exit(1);
+  }
   if (_list) {
     std::regex nameMatcher(_nameFilter);
+    std::vector<std::shared_ptr<BenchmarkBase>> selected;
     for (const auto& bm: _benchmarks) {
       if ((_nameFilter.empty() || std::regex_match(bm->_name, nameMatcher)) && (_typeFilter.empty() || _typeFilter == bm->_type)) {
-        std::cout << bm->_name << " - " << bm->_type << std::endl;
+        selected.push_back(bm);
       }
     }
+    if (_shardCount > 1) { selected = SelectShard(selected); }
+    for (const auto& bm: selected) {
+      std::cout << bm->_name << " - " << bm->_type << std::endl;
+    }
   }
   else {
+    // calibrated before the benchmarks run: a report from the watchdog thread (see OnTimeout()) must not calibrate
+    //  on a host that is still busy with the expired iteration
+    HostProfile::Get();
     Launcher::Launch(_nameFilter, _typeFilter);
   }
 }
@@ -96,20 +372,31 @@ void LauncherConsole::Report() {
     if (!_outputFile.empty()) {
       std::ofstream ofs(_outputFile);
       Launcher::Report(std::make_unique<ConsoleReporter>(ConsoleReporter(ofs)));
+      Launcher::Compare(std::make_unique<CompareReporter>(ofs));
     }
     else {
       Launcher::Report(std::make_unique<ConsoleReporter>(ConsoleReporter(std::cout)));
+      Launcher::Compare(std::make_unique<CompareReporter>(std::cout));
     }
   }
   else if (_outputType == "csv") {
+    std::string metadataFile = _metadataFile;
+    if (metadataFile.empty() && !_outputFile.empty()) { metadataFile = _outputFile + ".meta.csv"; }
+    std::ofstream metadata;
+    if (!metadataFile.empty()) { metadata.open(metadataFile); }
+    // a csv report on stdout without --metadata: the metadata goes to stderr, so the report stays parseable
+    std::ostream *metadataStream = metadataFile.empty() ? &std::cerr : &metadata;
     if (!_outputFile.empty()) {
       std::ofstream ofs(_outputFile);
-      Launcher::Report(std::make_unique<CSVReporter>(CSVReporter(ofs)));
+      Launcher::Report(std::make_unique<CSVReporter>(ofs, ",", metadataStream));
     }
     else {
-      Launcher::Report(std::make_unique<CSVReporter>(CSVReporter(std::cout)));
+      Launcher::Report(std::make_unique<CSVReporter>(std::cout, ",", metadataStream));
     }
   }
+  if (!_historyFile.empty()) {
+    Launcher::Report(std::make_unique<HistoryReporter>(_historyFile));
+  }
 }
 
 }  // namespace benchmarked
\ No newline at end of file
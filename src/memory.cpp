@@ -0,0 +1,182 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "benchmarked/memory.h"
+
+namespace benchmarked {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+char *AlignUp(char *ptr, std::size_t alignment) {
+  auto address = reinterpret_cast<std::uintptr_t>(ptr);
+  return ptr + ((alignment - address % alignment) % alignment);
+}
+
+}  // namespace
+
+// ===== ArenaResource =================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+ArenaResource::ArenaResource(std::size_t initialChunkSize, std::pmr::memory_resource *upstream)
+    : _upstream(upstream), _initialChunkSize(std::max<std::size_t>(initialChunkSize, 64)) {}
+
+// _____________________________________________________________________________________________________________________
+ArenaResource::~ArenaResource() {
+  Release();
+}
+
+// _____________________________________________________________________________________________________________________
+void ArenaResource::Reset() {
+  if (_chunks.empty()) { return; }
+  if (_chunks.size() > 1) {
+    // merge all chunks, so the next iteration of the same size fits into a single one
+    std::size_t capacity = _capacity;
+    Release();
+    _chunks.push_back({static_cast<char *>(_upstream->allocate(capacity, alignof(std::max_align_t))), capacity});
+    _capacity = capacity;
+  }
+  _current = 0;
+  _usedBefore = 0;
+  _ptr = _chunks[0].data;
+  _end = _chunks[0].data + _chunks[0].size;
+}
+
+// _____________________________________________________________________________________________________________________
+void ArenaResource::Release() {
+  for (const auto &chunk: _chunks) { _upstream->deallocate(chunk.data, chunk.size, alignof(std::max_align_t)); }
+  _chunks.clear();
+  _current = 0;
+  _usedBefore = 0;
+  _ptr = nullptr;
+  _end = nullptr;
+  _capacity = 0;
+}
+
+// _____________________________________________________________________________________________________________________
+std::size_t ArenaResource::Used() const {
+  return _chunks.empty() ? 0 : _usedBefore + static_cast<std::size_t>(_ptr - _chunks[_current].data);
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void *ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  char *ptr = _ptr == nullptr ? nullptr : AlignUp(_ptr, alignment);
+  if (ptr == nullptr || ptr > _end || static_cast<std::size_t>(_end - ptr) < bytes) {
+    NextChunk(bytes, alignment);
+    ptr = AlignUp(_ptr, alignment);
+  }
+  _ptr = ptr + bytes;
+  return ptr;
+}
+
+// _____________________________________________________________________________________________________________________
+void ArenaResource::NextChunk(std::size_t bytes, std::size_t alignment) {
+  std::size_t required = bytes + alignment;
+  std::size_t next = 0;
+  if (!_chunks.empty()) {
+    _usedBefore += static_cast<std::size_t>(_ptr - _chunks[_current].data);
+    next = _current + 1;
+  }
+  for (; next < _chunks.size(); ++next) {
+    if (_chunks[next].size >= required) { break; }
+  }
+  if (next == _chunks.size()) {
+    std::size_t size = std::max({_initialChunkSize, _chunks.empty() ? 0 : 2 * _chunks.back().size, required});
+    _chunks.push_back({static_cast<char *>(_upstream->allocate(size, alignof(std::max_align_t))), size});
+    _capacity += size;
+  }
+  _current = next;
+  _ptr = _chunks[next].data;
+  _end = _chunks[next].data + _chunks[next].size;
+}
+
+// ===== PoolResource ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+PoolResource::PoolResource(std::pmr::memory_resource *upstream) : _arena(64 * 1024, upstream) {}
+
+// _____________________________________________________________________________________________________________________
+void PoolResource::Reset() {
+  _free.fill(nullptr);
+  _arena.Reset();
+}
+
+// _____________________________________________________________________________________________________________________
+void PoolResource::Release() {
+  _free.fill(nullptr);
+  _arena.Release();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void *PoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  std::size_t sizeClass = SizeClass(bytes, alignment);
+  if (sizeClass == CLASSES) { return _arena.allocate(bytes, alignment); }
+  if (FreeBlock *block = _free[sizeClass]) {
+    _free[sizeClass] = block->next;
+    return block;
+  }
+  // blocks are aligned to their size, which covers every alignment mapped to this class
+  std::size_t blockSize = MIN_BLOCK_SIZE << sizeClass;
+  std::size_t count = std::max<std::size_t>(REFILL_BYTES / blockSize, 1);
+  auto *batch = static_cast<char *>(_arena.allocate(blockSize * count, blockSize));
+  for (std::size_t i = count - 1; i > 0; --i) {
+    auto *block = reinterpret_cast<FreeBlock *>(batch + i * blockSize);
+    block->next = _free[sizeClass];
+    _free[sizeClass] = block;
+  }
+  return batch;
+}
+
+// _____________________________________________________________________________________________________________________
+void PoolResource::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+  std::size_t sizeClass = SizeClass(bytes, alignment);
+  if (sizeClass == CLASSES) { return; }
+  auto *block = static_cast<FreeBlock *>(p);
+  block->next = _free[sizeClass];
+  _free[sizeClass] = block;
+}
+
+// _____________________________________________________________________________________________________________________
+std::size_t PoolResource::SizeClass(std::size_t bytes, std::size_t alignment) {
+  std::size_t size = std::max({bytes, alignment, MIN_BLOCK_SIZE});
+  if (size > MAX_BLOCK_SIZE) { return CLASSES; }
+  return std::bit_width(size - 1) - std::bit_width(MIN_BLOCK_SIZE - 1);
+}
+
+// ===== Allocator =====================================================================================================
+// _____________________________________________________________________________________________________________________
+const char *ToString(Allocator allocator) {
+  switch (allocator) {
+    case Allocator::Malloc: return "malloc";
+    case Allocator::Arena: return "arena";
+    case Allocator::Pool: return "pool";
+  }
+  return "";
+}
+
+// ===== AllocatorFixture ==============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void AllocatorFixture::SetAllocator(Allocator allocator) {
+  _allocator = allocator;
+  switch (allocator) {
+    case Allocator::Malloc: _memoryResource = std::pmr::new_delete_resource(); break;
+    case Allocator::Arena: _memoryResource = &_arena; break;
+    case Allocator::Pool: _memoryResource = &_pool; break;
+  }
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void AllocatorFixture::ResetMemory() {
+  if (_allocator == Allocator::Arena) { _arena.Reset(); }
+  if (_allocator == Allocator::Pool) { _pool.Reset(); }
+}
+
+}  // namespace benchmarked
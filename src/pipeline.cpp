@@ -0,0 +1,122 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include "benchmarked/pipeline.h"
+
+namespace benchmarked {
+
+// ===== InputPipeline =================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+InputPipeline::~InputPipeline() {
+  Join();
+}
+
+// ----- protected -----------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void InputPipeline::Pushed() {
+  {
+    std::unique_lock locker(_pipelineMutex);
+    ++_ready;
+  }
+  _pipelineCondVar.notify_all();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void InputPipeline::StartPipeline(std::size_t depth, uint64_t inputs) {
+  Join();
+  {
+    std::unique_lock locker(_pipelineMutex);
+    Clear();
+    _depth = depth;
+    _ready = 0;
+    _stop = false;
+    _error = nullptr;
+  }
+#if defined(__linux__)
+  // keep the measured thread on its current core and move the producer to the remaining ones
+  cpu_set_t allowed;
+  int cpu = sched_getcpu();
+  _pinned = false;
+  if (cpu >= 0 && sched_getaffinity(0, sizeof(allowed), &allowed) == 0 && CPU_COUNT(&allowed) > 1) {
+    cpu_set_t measured;
+    CPU_ZERO(&measured);
+    CPU_SET(cpu, &measured);
+    if (sched_setaffinity(0, sizeof(measured), &measured) == 0) {
+      _previousAffinity = allowed;
+      _pinned = true;
+      CPU_CLR(cpu, &allowed);
+    }
+  }
+  _producer = std::thread([this, inputs, allowed, pinned = _pinned]() {
+    if (pinned) { sched_setaffinity(0, sizeof(allowed), &allowed); }
+    ProducerLoop(inputs);
+  });
+#else
+  _producer = std::thread([this, inputs]() { ProducerLoop(inputs); });
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void InputPipeline::NextInput() {
+  std::unique_lock locker(_pipelineMutex);
+  _pipelineCondVar.wait(locker, [this]() { return _ready > 0 || _error || _stop; });
+  if (_ready == 0) {
+    if (_error) { std::rethrow_exception(_error); }
+    return;
+  }
+  Consume();
+  --_ready;
+  locker.unlock();
+  _pipelineCondVar.notify_all();
+}
+
+// _____________________________________________________________________________________________________________________
+void InputPipeline::StopPipeline() {
+  Join();
+  {
+    std::unique_lock locker(_pipelineMutex);
+    Clear();
+    _ready = 0;
+  }
+#if defined(__linux__)
+  if (_pinned) {
+    sched_setaffinity(0, sizeof(_previousAffinity), &_previousAffinity);
+    _pinned = false;
+  }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void InputPipeline::Join() {
+  {
+    std::unique_lock locker(_pipelineMutex);
+    _stop = true;
+  }
+  _pipelineCondVar.notify_all();
+  if (_producer.joinable()) { _producer.join(); }
+}
+
+// _____________________________________________________________________________________________________________________
+void InputPipeline::ProducerLoop(uint64_t inputs) {
+  for (uint64_t produced = 0; produced < inputs; ++produced) {
+    {
+      std::unique_lock locker(_pipelineMutex);
+      _pipelineCondVar.wait(locker, [this]() { return _ready < _depth || _stop; });
+      if (_stop) { return; }
+    }
+    try {
+      Produce();
+    } catch (...) {
+      {
+        std::unique_lock locker(_pipelineMutex);
+        _error = std::current_exception();
+      }
+      _pipelineCondVar.notify_all();
+      return;
+    }
+  }
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,116 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmarked/process.h"
+
+extern char **environ;
+
+namespace benchmarked {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+uint64_t ToNanoseconds(const timeval &time) {
+  return static_cast<uint64_t>(time.tv_sec) * 1000 * 1000 * 1000 + static_cast<uint64_t>(time.tv_usec) * 1000;
+}
+
+}  // namespace
+
+// ===== ProcessBenchmark ==============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+ProcessBenchmark::ProcessBenchmark(std::vector<std::string> command, const std::string &name, const std::string &type,
+                                   const std::string &description, uint64_t iterations, BenchmarkOptions options)
+    : BenchmarkBase(name, type, description, iterations, []() {}, std::move(options)), _command(std::move(command)) {
+  if (_command.empty()) {
+    throw std::invalid_argument("The command of process benchmark '" + name + "' is empty.");
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void ProcessBenchmark::Launch() {
+  int64_t wall_ns = 0;
+  for (unsigned run = 0; run < _options.processWarmup && !DeadlineReached(); ++run) {
+    if (!_options.processPrepare.empty()) { Spawn(_options.processPrepare, _options.processOutput, wall_ns); }
+    Spawn(_command, _options.processOutput, wall_ns);
+  }
+
+  for (uint64_t iteration = 0; iteration < _iterations && !DeadlineReached(); ++iteration) {
+    if (!_options.processPrepare.empty()) { Spawn(_options.processPrepare, _options.processOutput, wall_ns); }
+    _cleanUp();
+
+    auto armed = ArmWatchdog();
+    ProcessRun run = Spawn(_command, _options.processOutput, wall_ns);
+    armed.Disarm();
+
+    Record([&]() {
+      _results.emplace_back(timed::Time(std::chrono::nanoseconds(run.user_ns + run.sys_ns)),
+                            timed::Time(std::chrono::nanoseconds(wall_ns)));
+      _processRuns.push_back(run);
+    });
+  }
+  _launched = true;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+ProcessRun ProcessBenchmark::Spawn(const std::vector<std::string> &argv, bool output, int64_t &wall_ns) {
+  std::vector<char *> args;
+  args.reserve(argv.size() + 1);
+  for (const auto &arg: argv) { args.push_back(const_cast<char *>(arg.c_str())); }
+  args.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (!output) { posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0); }
+
+  // the child starts out in (a copy of) the address space of this process, so its peak resident set size includes
+  //  the one of this process and is only meaningful if it exceeds it
+  rusage self{};
+  getrusage(RUSAGE_SELF, &self);
+
+  pid_t pid;
+  auto start = std::chrono::steady_clock::now();
+  int error = posix_spawnp(&pid, args[0], &actions, nullptr, args.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  if (error != 0) {
+    throw std::runtime_error("Starting '" + argv[0] + "' failed: " + std::strerror(error));
+  }
+
+  int status = 0;
+  rusage usage{};
+  pid_t waited;
+  do {
+    waited = wait4(pid, &status, 0, &usage);
+  } while (waited < 0 && errno == EINTR);
+  auto end = std::chrono::steady_clock::now();
+  if (waited < 0) {
+    throw std::runtime_error("Waiting for '" + argv[0] + "' failed: " + std::strerror(errno));
+  }
+  if (WIFSIGNALED(status)) {
+    throw std::runtime_error("'" + argv[0] + "' was killed by signal " + std::to_string(WTERMSIG(status)) + ".");
+  }
+  if (WEXITSTATUS(status) != 0) {
+    throw std::runtime_error("'" + argv[0] + "' exited with status " + std::to_string(WEXITSTATUS(status)) + ".");
+  }
+
+  wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  ProcessRun run;
+  run.user_ns = ToNanoseconds(usage.ru_utime);
+  run.sys_ns = ToNanoseconds(usage.ru_stime);
+  run.peakRss_kb = usage.ru_maxrss > self.ru_maxrss ? static_cast<uint64_t>(usage.ru_maxrss) : 0;
+  return run;
+}
+
+}  // namespace benchmarked
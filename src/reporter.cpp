@@ -1,13 +1,71 @@
 // Copyright Leon Freist
 // Author Leon Freist <freist@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 #include "benchmarked/reporter.h"
+#include "benchmarked/calibration.h"
+#include "benchmarked/environment.h"
+#include "benchmarked/statistics.h"
+
+namespace benchmarked {
 
-#include "timed/utils/Statistics.h"
+namespace {
 
-#include "hwinfo/hwinfo.h"
+// columns appended to every CSV row after the statistics columns, empty where they do not apply
+const char *const CSV_COLUMNS[] = {
+    // "ok", "timed out" if the benchmark exceeded its time limit or "skipped" if it was not run since a benchmark
+    //  before it exceeded its time limit, on every row of the benchmark
+    "status",
+    // paired comparisons: wall time ratio of the second to the first variant, on the row of the first one
+    "wall-ratio", "wall-ratio-low", "wall-ratio-high",
+    // role benchmarks: one row "<name> [<role>]" per role, with the operations of all its threads
+    "role-threads", "role-ops/s", "role-p50 [ns]", "role-p99 [ns]", "role-max [ns]",
+    // multi-threaded benchmarks: time between the release of the first and the last thread over all iterations
+    "start-skew-median [ns]", "start-skew-max [ns]",
+    // how the confidence intervals of the means were computed (see statistics::Summarize()), the ones of the medians
+    //  are always the exact bootstrap distribution
+    "cpu-mean-ci-method", "wall-mean-ci-method",
+    // process benchmarks: median user and system CPU time of the measured runs and the largest peak RSS of a run (0 if
+    //  no run exceeded the peak RSS of the benchmark process), on the row of the benchmark
+    "process-user-median [ns]", "process-sys-median [ns]", "process-peak-rss-max [KiB]",
+    // benchmarks with BenchmarkOptions::ioAccounting: logical and device bytes per iteration and the throughput over
+    //  the wall time of all iterations, on the row of the benchmark
+    "io-read [B]", "io-write [B]", "io-device-read [B]", "io-device-write [B]",
+    "io-read [MiB/s]", "io-write [MiB/s]", "io-device-read [MiB/s]", "io-device-write [MiB/s]",
+};
 
-namespace benchmarked {
+/**
+ * IOSummary: I/O of all iterations that recorded it (see BenchmarkOptions::ioAccounting).
+ */
+struct IOSummary {
+  IOSummary(const std::vector<IOCounters> &io, const std::vector<Result> &results) {
+    for (const auto &counters: io) { total += counters; }
+    for (std::size_t i = 0; i < io.size() && i < results.size(); ++i) {
+      wall_s += results[i].wallTime.getMilliseconds() / 1000;
+    }
+    iterations = static_cast<double>(io.size());
+  }
+
+  [[nodiscard]] double MiBPerSecond(uint64_t bytes) const {
+    return wall_s > 0 ? static_cast<double>(bytes) / 1024 / 1024 / wall_s : 0;
+  }
+
+  [[nodiscard]] double PerIteration(uint64_t value) const {
+    return iterations > 0 ? static_cast<double>(value) / iterations : 0;
+  }
+
+  IOCounters total;
+  double wall_s = 0;
+  double iterations = 0;
+};
+
+}  // namespace
 
 // ===== ConsoleReporter ===============================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
@@ -16,15 +74,50 @@ ConsoleReporter::ConsoleReporter(std::ostream &ostream) : _stream(ostream) {}
 
 // _____________________________________________________________________________________________________________________
 void ConsoleReporter::ReportInit(const std::string &launcherName) {
-  hwinfo::CPU cpu;
-  hwinfo::RAM ram;
   _stream << "\nBenchmark Report: " << launcherName << '\n'
-          << "================================================================================\n"
-          << "--- HARDWARE -------------------------------------------------------------------\n"
-          << "CPU model:       " << cpu.modelName() << "\n"
-          << "CPU cores:       " << cpu.numLogicalCores() << " (" << cpu.numPhysicalCores() << ")\n"
-          << "CPU clock speed: " << cpu.regularClockSpeed_kHz() << " (" << cpu.maxClockSpeed_kHz() << ") MHz\n"
-          << "RAM size:        " << (static_cast<double>(ram.totalSize_Bytes()) / 1000 / 1000 / 1000) << " GiB\n"
+          << "================================================================================\n";
+  if (_recorded) {
+    _stream << "--- ENVIRONMENT (recorded) -----------------------------------------------------\n";
+    for (const auto &[name, value]: _recorded->entries) {
+      _stream << std::left << std::setw(25) << name << std::right << value << "\n";
+    }
+    _stream << "--- HOST PROFILE (recorded) ----------------------------------------------------\n";
+    for (const auto &[name, value]: _recorded->hostProfile) {
+      _stream << std::left << std::setw(25) << name << std::right << value << "\n";
+    }
+    _stream << "================================================================================\n"
+            << "--- BENCHMARKS -----------------------------------------------------------------\n"
+            << std::flush;
+    return;
+  }
+  const auto &env = Environment::Get();
+  _stream << "--- HARDWARE -------------------------------------------------------------------\n"
+          << "CPU model:       " << env.cpuModel << "\n"
+          << "CPU cores:       " << env.logicalCores << " (" << env.physicalCores << ")\n"
+          << "CPU clock speed: " << env.regularClockSpeed_kHz << " (" << env.maxClockSpeed_kHz << ") MHz\n"
+          << "RAM size:        " << (static_cast<double>(env.ramSize_Bytes) / 1000 / 1000 / 1000) << " GiB\n";
+  if (!env.caches.empty()) {
+    _stream << "CPU caches:     ";
+    for (const auto &[name, size]: env.caches) { _stream << " " << name << " " << size / 1024 << " KiB"; }
+    _stream << "\n";
+  }
+  _stream << "--- SOFTWARE -------------------------------------------------------------------\n"
+          << "Kernel:          " << env.kernel << "\n"
+          << "Compiler:        " << env.compiler << "\n"
+          << "Library build:   " << env.buildType << " (" << env.buildFlags << ")\n"
+          << "Git SHA:         " << env.gitSha << "\n";
+  if (!env.cpuGovernor.empty()) {
+    _stream << "CPU governor:    " << env.cpuGovernor << "\n";
+  }
+  for (const auto &[name, value]: env.variables) {
+    _stream << "$" << name << "=" << value << "\n";
+  }
+  _stream << "--- HOST PROFILE ---------------------------------------------------------------\n";
+  const auto &profile = HostProfile::Get();
+  for (const auto &[name, value]: profile.Metrics()) {
+    _stream << std::left << std::setw(25) << name << std::right << value << "\n";
+  }
+  _stream << "(calibrated in " << profile.duration_ms << " ms)\n"
           << "================================================================================\n"
           << "--- BENCHMARKS -----------------------------------------------------------------\n"
           << std::flush;
@@ -32,7 +125,22 @@ void ConsoleReporter::ReportInit(const std::string &launcherName) {
 
 // _____________________________________________________________________________________________________________________
 void ConsoleReporter::ReportBenchmark(BenchmarkBase *benchmark) {
+  if (!benchmark->_loadCurve.empty()) {
+    ReportLoadCurve(benchmark);
+    return;
+  }
+  if (benchmark->_skipped) {
+    _stream << "--------------------------------------------------------------------------------\n"
+            << "Benchmark:       " << benchmark->_name << "\n"
+            << "Status:          skipped, a benchmark before it exceeded its time limit" << std::endl;
+    return;
+  }
   if (benchmark->_results.empty()) {
+    if (benchmark->_timedOut) {
+      _stream << "--------------------------------------------------------------------------------\n"
+              << "Benchmark:       " << benchmark->_name << "\n"
+              << "Status:          timed out before the first iteration finished\n";
+    }
     _stream << "No Results collected..." << std::endl;
     return;
   }
@@ -49,22 +157,17 @@ void ConsoleReporter::ReportBenchmark(BenchmarkBase *benchmark) {
           << "Benchmark:       " << benchmark->_name << "\n"
           << "Description:     " << benchmark->_description << "\n"
           << "Iterations:      " << benchmark->_iterations << "\n";
+  if (benchmark->_timedOut) {
+    _stream << "Status:          timed out after " << benchmark->_results.size() << " iterations\n";
+  }
   if (benchmark->_iterations > 1) {
     if (!cpuTimes_ms.empty()) {
-      _stream << "  -------------------------------- CPU Time ------------------------------------\n"
-              << "  min:           " << timed::utils::min(cpuTimes_ms) << " ms\n"
-              << "  max:           " << timed::utils::max(cpuTimes_ms) << " ms\n"
-              << "  mean:          " << timed::utils::mean(cpuTimes_ms) << " ms\n"
-              << "  median:        " << timed::utils::median(cpuTimes_ms) << " ms\n"
-              << "  % err          " << timed::utils::medianAbsolutePercentError(cpuTimes_ms) << "\n";
+      _stream << "  -------------------------------- CPU Time ------------------------------------\n";
+      ReportSummary(statistics::Summarize(cpuTimes_ms));
     }
     if (!wallTimes_ms.empty()) {
-      _stream << "  ------------------------------- WALL Time ------------------------------------\n"
-              << "  min:           " << timed::utils::min(wallTimes_ms) << " ms\n"
-              << "  max:           " << timed::utils::max(wallTimes_ms) << " ms\n"
-              << "  mean:          " << timed::utils::mean(wallTimes_ms) << " ms\n"
-              << "  median:        " << timed::utils::median(wallTimes_ms) << " ms\n"
-              << "  % err          " << timed::utils::medianAbsolutePercentError(wallTimes_ms) << "\n";
+      _stream << "  ------------------------------- WALL Time ------------------------------------\n";
+      ReportSummary(statistics::Summarize(wallTimes_ms));
     }
   }
   else {
@@ -77,6 +180,223 @@ void ConsoleReporter::ReportBenchmark(BenchmarkBase *benchmark) {
               << "  wall time:     " << wallTimes_ms[0] << " ms\n";
     }
   }
+  if (!benchmark->_latencies_ns.empty()) {
+    ReportLatencies(benchmark);
+  }
+  if (!benchmark->_processRuns.empty()) {
+    ReportProcessRuns(benchmark);
+  }
+  if (!benchmark->_roleResults.empty()) {
+    ReportRoles(benchmark);
+  }
+  if (!benchmark->_startSkew_ns.empty()) {
+    ReportStartSkew(benchmark);
+  }
+  if (!benchmark->_io.empty()) {
+    ReportIO(benchmark);
+  }
+  if (!benchmark->_variants.empty()) {
+    ReportVariants(benchmark);
+  }
+  _stream << std::flush;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportSummary(const statistics::Summary &summary) {
+  _stream << "  min:           " << summary.min << " ms\n"
+          << "  max:           " << summary.max << " ms\n"
+          << "  mean:          " << summary.mean << " ms [" << summary.meanCI.low << ", " << summary.meanCI.high
+          << "] (" << summary.meanCI.confidence * 100 << "% CI, " << statistics::ToString(summary.meanCI.method)
+          << ")\n"
+          << "  median:        " << summary.median << " ms [" << summary.medianCI.low << ", " << summary.medianCI.high
+          << "] (" << summary.medianCI.confidence * 100 << "% CI, " << statistics::ToString(summary.medianCI.method)
+          << ")\n"
+          << "  std dev:       " << summary.stddev << " ms\n"
+          << "  % err          " << summary.medianAbsolutePercentError << "\n"
+          << "  outliers:      " << summary.Outliers() << " of " << summary.count;
+  if (summary.Outliers() > 0) {
+    _stream << " (low: " << summary.lowSevere << " severe, " << summary.lowMild << " mild; high: " << summary.highMild
+            << " mild, " << summary.highSevere << " severe)";
+  }
+  _stream << "\n";
+  // lag-1 autocorrelations beyond ~2 / sqrt(n) are unlikely for independent iterations
+  bool correlated = std::abs(summary.autocorrelation) > std::max(0.2, 2 / std::sqrt(static_cast<double>(summary.count)));
+  _stream << "  autocorr.:     " << summary.autocorrelation
+          << (correlated ? " (WARNING: consecutive iterations are correlated, e.g. by warm-up or throttling)" : "")
+          << "\n";
+  if (summary.Multimodal()) {
+    _stream << "  shape:         WARNING: " << summary.modes << " modes (bimodality coefficient "
+            << summary.bimodalityCoefficient << "), e.g. caused by frequency scaling\n";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportVariants(BenchmarkBase *benchmark) {
+  auto medianWall_ms = [](const std::vector<Result> &results) {
+    std::vector<double> times;
+    for (const auto &res: results) { times.push_back(res.wallTime.getMilliseconds()); }
+    return statistics::Percentile(std::move(times), 50);
+  };
+  auto medianCPU_ms = [](const std::vector<Result> &results) {
+    std::vector<double> times;
+    for (const auto &res: results) { times.push_back(res.cpuTime.getMilliseconds()); }
+    return statistics::Percentile(std::move(times), 50);
+  };
+  double reference = medianWall_ms(benchmark->_results);
+  auto printRow = [&](const std::string &label, const std::vector<Result> &results) {
+    double wall = medianWall_ms(results);
+    _stream << "  " << std::left << std::setw(16) << label << std::right
+            << std::setw(14) << medianCPU_ms(results) << std::setw(14) << wall;
+    if (reference > 0) {
+      _stream << std::setw(10) << wall / reference << "x";
+    }
+    _stream << "\n";
+  };
+  _stream << "  ---------------------------------- Variants ----------------------------------\n"
+          << "  " << std::left << std::setw(16) << "variant" << std::right << std::setw(14) << "cpu med [ms]"
+          << std::setw(14) << "wall med [ms]" << std::setw(11) << "ratio" << "\n";
+  printRow(benchmark->_resultsLabel, benchmark->_results);
+  for (const auto &variant: benchmark->_variants) {
+    printRow(variant.label, variant.results);
+  }
+  if (benchmark->_comparison) {
+    const auto &ratio = *benchmark->_comparison;
+    _stream << "  paired ratio:  " << benchmark->_variants.front().label << " / " << benchmark->_resultsLabel << " = "
+            << ratio.value << " [" << ratio.low << ", " << ratio.high << "] (" << ratio.confidence * 100 << "% CI, "
+            << statistics::ToString(ratio.method) << ")";
+    if (ratio.high < 1) {
+      _stream << " -> " << benchmark->_variants.front().label << " is faster\n";
+    } else if (ratio.low > 1) {
+      _stream << " -> " << benchmark->_variants.front().label << " is slower\n";
+    } else {
+      _stream << " -> no significant difference\n";
+    }
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportLatencies(BenchmarkBase *benchmark) {
+  std::vector<double> latencies_us;
+  latencies_us.reserve(benchmark->_latencies_ns.size());
+  for (auto latency: benchmark->_latencies_ns) { latencies_us.push_back(static_cast<double>(latency) / 1000); }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  double wall_s = 0;
+  for (const auto &res: benchmark->_results) { wall_s += res.wallTime.getMilliseconds() / 1000; }
+  _stream << "  ----------------------------- Operation Latency ------------------------------\n"
+          << "  operations:    " << latencies_us.size() << " (" << benchmark->_options.asyncConcurrency
+          << " in flight)\n"
+          << "  throughput:    " << (wall_s > 0 ? static_cast<double>(latencies_us.size()) / wall_s : 0) << " ops/s\n"
+          << "  p50:           " << statistics::PercentileSorted(latencies_us, 50) << " us\n"
+          << "  p99:           " << statistics::PercentileSorted(latencies_us, 99) << " us\n"
+          << "  max:           " << latencies_us.back() << " us\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportProcessRuns(BenchmarkBase *benchmark) {
+  std::vector<double> user_ms;
+  std::vector<double> sys_ms;
+  std::vector<double> peakRss_mib;
+  for (const auto &run: benchmark->_processRuns) {
+    user_ms.push_back(static_cast<double>(run.user_ns) / 1000 / 1000);
+    sys_ms.push_back(static_cast<double>(run.sys_ns) / 1000 / 1000);
+    if (run.peakRss_kb > 0) { peakRss_mib.push_back(static_cast<double>(run.peakRss_kb) / 1024); }
+  }
+  _stream << "  ---------------------------------- Process -----------------------------------\n"
+          << "  user median:   " << statistics::Summarize(user_ms).median << " ms\n"
+          << "  sys median:    " << statistics::Summarize(sys_ms).median << " ms\n";
+  if (peakRss_mib.empty()) {
+    _stream << "  peak RSS:      below the peak RSS of the benchmark process\n";
+    return;
+  }
+  auto rss = statistics::Summarize(peakRss_mib);
+  _stream << "  peak RSS:      " << rss.median << " MiB (min: " << rss.min << ", max: " << rss.max << ")";
+  if (peakRss_mib.size() < benchmark->_processRuns.size()) {
+    _stream << ", " << benchmark->_processRuns.size() - peakRss_mib.size() << " runs below the benchmark process";
+  }
+  _stream << "\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportRoles(BenchmarkBase *benchmark) {
+  _stream << "  ----------------------------------- Roles ------------------------------------\n"
+          << "  " << std::left << std::setw(12) << "role" << std::right << std::setw(8) << "threads" << std::setw(14)
+          << "ops/s" << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]" << std::setw(12) << "max [us]"
+          << "\n";
+  for (const auto &role: benchmark->_roleResults) {
+    double wall_s = static_cast<double>(role.wall_ns) / 1000 / 1000 / 1000;
+    _stream << "  " << std::left << std::setw(12) << role.name << std::right << std::setw(8) << role.threads
+            << std::setw(14) << (wall_s > 0 ? static_cast<double>(role.operations) / wall_s : 0)
+            << std::setw(12) << role.latencies.Percentile(50) / 1000
+            << std::setw(12) << role.latencies.Percentile(99) / 1000
+            << std::setw(12) << static_cast<double>(role.latencies.Max()) / 1000 << "\n";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportStartSkew(BenchmarkBase *benchmark) {
+  std::vector<double> skews_us;
+  for (auto skew: benchmark->_startSkew_ns) { skews_us.push_back(static_cast<double>(skew) / 1000); }
+  std::vector<double> wallTimes_us;
+  for (const auto &res: benchmark->_results) { wallTimes_us.push_back(res.wallTime.getMilliseconds() * 1000); }
+  auto skew = statistics::Summarize(skews_us);
+  double wall_us = statistics::Summarize(wallTimes_us).median;
+  _stream << "  start skew:    " << skew.median << " us median, " << skew.max << " us max";
+  // threads released late measure less work than the others: beyond 1% of an iteration the numbers are distorted
+  if (wall_us > 0 && skew.max > 0.01 * wall_us) {
+    _stream << " (WARNING: " << skew.max / wall_us * 100 << "% of the median iteration)";
+  }
+  _stream << "\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportIO(BenchmarkBase *benchmark) {
+  IOSummary io(benchmark->_io, benchmark->_results);
+  const auto &total = io.total;
+  _stream << "  ------------------------------------- I/O ------------------------------------\n"
+          << "  logical:       read " << io.MiBPerSecond(total.rchar) << " MiB/s, write "
+          << io.MiBPerSecond(total.wchar) << " MiB/s\n"
+          << "  device:        read " << io.MiBPerSecond(total.readBytes) << " MiB/s, write "
+          << io.MiBPerSecond(total.writeBytes) << " MiB/s\n"
+          << "  per iteration: " << io.PerIteration(total.syscr) << " read and " << io.PerIteration(total.syscw)
+          << " write calls, " << io.PerIteration(total.readBytes) / 1024 << " KiB read and "
+          << io.PerIteration(total.writeBytes) / 1024 << " KiB written by the device\n";
+  if (total.rchar > 0) {
+    // logical reads not reaching the device were served by the page cache
+    _stream << "  page cache:    " << 100 - std::min(100.0, 100.0 * static_cast<double>(total.readBytes) /
+                                                            static_cast<double>(total.rchar))
+            << "% of the logical reads served\n";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::ReportLoadCurve(BenchmarkBase *benchmark) {
+  _stream << "--------------------------------------------------------------------------------\n"
+          << "Benchmark:       " << benchmark->_name << "\n"
+          << "Description:     " << benchmark->_description << "\n"
+          << "Operations:      " << benchmark->_iterations << " per step ("
+          << (benchmark->_options.arrival == Arrival::Poisson ? "poisson" : "fixed") << " arrivals, "
+          << benchmark->_options.openLoopWorkers << " worker" << (benchmark->_options.openLoopWorkers == 1 ? "" : "s")
+          << ")\n";
+  if (benchmark->_timedOut) {
+    _stream << "Status:          timed out after " << benchmark->_loadCurve.size() << " load steps\n";
+  }
+  _stream << "  ----------------------- Latency [us] vs. offered load ------------------------\n"
+          << std::setw(12) << "offered/s" << std::setw(12) << "achieved/s" << std::setw(11) << "p50"
+          << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::setw(12) << "max\n";
+  for (const auto &point: benchmark->_loadCurve) {
+    std::vector<double> latencies_us;
+    latencies_us.reserve(point.latencies_ns.size());
+    for (auto latency: point.latencies_ns) { latencies_us.push_back(static_cast<double>(latency) / 1000); }
+    std::sort(latencies_us.begin(), latencies_us.end());
+    _stream << std::setw(12) << point.offeredRate << std::setw(12) << point.achievedRate
+            << std::setw(11) << statistics::PercentileSorted(latencies_us, 50)
+            << std::setw(11) << statistics::PercentileSorted(latencies_us, 90)
+            << std::setw(11) << statistics::PercentileSorted(latencies_us, 99)
+            << std::setw(11) << statistics::PercentileSorted(latencies_us, 99.9)
+            << std::setw(11) << (latencies_us.empty() ? 0 : latencies_us.back())
+            << (point.saturated ? " (saturated)" : "") << "\n";
+  }
   _stream << std::flush;
 }
 
@@ -84,45 +404,253 @@ void ConsoleReporter::ReportBenchmark(BenchmarkBase *benchmark) {
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
 void CSVReporter::ReportInit(const std::string &launcherName) {
+  if (_metadata != nullptr) {
+    *_metadata << "kind" << _separator << "name" << _separator << "value\n";
+    for (const auto &[name, value]: _recorded ? _recorded->entries : Environment::Get().Entries()) {
+      *_metadata << "env" << _separator << Quote(name) << _separator << Quote(value) << '\n';
+    }
+    for (const auto &[name, value]: _recorded ? _recorded->hostProfile : HostProfile::Get().Metrics()) {
+      *_metadata << "host" << _separator << Quote(name) << _separator << value << '\n';
+    }
+    *_metadata << std::flush;
+  }
   _stream << "name" << _separator << "description" << _separator << "iterations" << _separator << "cpu-min [ns]"
           << _separator << "cpu-max [ns]" << _separator << "cpu-mean [ns]" << _separator << "cpu-median [ns]"
           << _separator
           << "cpu-%err" << _separator << "wall-min [ns]" << _separator << "wall-max [ns]" << _separator
           << "wall-mean [ns]"
-          << _separator << "wall-median [ns]" << _separator << "wall-%err\n";
+          << _separator << "wall-median [ns]" << _separator << "wall-%err";
+  for (const std::string prefix: {"cpu", "wall"}) {
+    _stream << _separator << prefix << "-mean-low [ns]" << _separator << prefix << "-mean-high [ns]" << _separator
+            << prefix << "-median-low [ns]" << _separator << prefix << "-median-high [ns]" << _separator << prefix
+            << "-stddev [ns]" << _separator << prefix << "-outliers" << _separator << prefix << "-modes" << _separator
+            << prefix << "-autocorrelation";
+  }
+  for (const auto *column: CSV_COLUMNS) { _stream << _separator << column; }
+  _stream << "\n";
 }
 
 // _____________________________________________________________________________________________________________________
 void CSVReporter::ReportBenchmark(BenchmarkBase *benchmark) {
-  if (benchmark->_results.empty()) {
-    _stream << _separator << _separator << _separator << _separator << _separator << _separator << _separator
-            << _separator << _separator << _separator << _separator << _separator << '\n';
-    _stream << std::flush;
+  const Columns status = {{"status", benchmark->_skipped ? "skipped" : benchmark->_timedOut ? "timed out" : "ok"}};
+  if (!benchmark->_loadCurve.empty()) {
+    // one row per load step, the wall columns hold the latencies measured from the intended start
+    for (const auto &point: benchmark->_loadCurve) {
+      std::stringstream name;
+      name << benchmark->_name << " [" << point.offeredRate << "/s]";
+      ReportRow(name.str(), benchmark->_description, benchmark->_iterations, {}, point.latencies_ns, status);
+    }
     return;
   }
+  Columns columns = status;
+  if (benchmark->_comparison) {
+    columns["wall-ratio"] = std::to_string(benchmark->_comparison->value);
+    columns["wall-ratio-low"] = std::to_string(benchmark->_comparison->low);
+    columns["wall-ratio-high"] = std::to_string(benchmark->_comparison->high);
+  }
+  if (!benchmark->_startSkew_ns.empty()) {
+    std::vector<double> skews_ns(benchmark->_startSkew_ns.begin(), benchmark->_startSkew_ns.end());
+    columns["start-skew-median [ns]"] = std::to_string(std::llround(statistics::Percentile(skews_ns, 50)));
+    columns["start-skew-max [ns]"] = std::to_string(std::llround(statistics::Percentile(skews_ns, 100)));
+  }
+  if (!benchmark->_processRuns.empty()) {
+    std::vector<double> user_ns;
+    std::vector<double> sys_ns;
+    uint64_t peakRss_kb = 0;
+    for (const auto &run: benchmark->_processRuns) {
+      user_ns.push_back(static_cast<double>(run.user_ns));
+      sys_ns.push_back(static_cast<double>(run.sys_ns));
+      peakRss_kb = std::max(peakRss_kb, run.peakRss_kb);
+    }
+    columns["process-user-median [ns]"] = std::to_string(std::llround(statistics::Percentile(user_ns, 50)));
+    columns["process-sys-median [ns]"] = std::to_string(std::llround(statistics::Percentile(sys_ns, 50)));
+    columns["process-peak-rss-max [KiB]"] = std::to_string(peakRss_kb);
+  }
+  if (!benchmark->_io.empty()) {
+    IOSummary io(benchmark->_io, benchmark->_results);
+    columns["io-read [B]"] = std::to_string(std::llround(io.PerIteration(io.total.rchar)));
+    columns["io-write [B]"] = std::to_string(std::llround(io.PerIteration(io.total.wchar)));
+    columns["io-device-read [B]"] = std::to_string(std::llround(io.PerIteration(io.total.readBytes)));
+    columns["io-device-write [B]"] = std::to_string(std::llround(io.PerIteration(io.total.writeBytes)));
+    columns["io-read [MiB/s]"] = std::to_string(io.MiBPerSecond(io.total.rchar));
+    columns["io-write [MiB/s]"] = std::to_string(io.MiBPerSecond(io.total.wchar));
+    columns["io-device-read [MiB/s]"] = std::to_string(io.MiBPerSecond(io.total.readBytes));
+    columns["io-device-write [MiB/s]"] = std::to_string(io.MiBPerSecond(io.total.writeBytes));
+  }
+  ReportResults(benchmark, benchmark->_name, benchmark->_results, columns);
+  if (!benchmark->_latencies_ns.empty()) {
+    ReportRow(benchmark->_name + " [operations]", benchmark->_description, benchmark->_latencies_ns.size(), {},
+              benchmark->_latencies_ns, status);
+  }
+  for (const auto &variant: benchmark->_variants) {
+    ReportResults(benchmark, benchmark->_name + " [" + variant.label + "]", variant.results, status);
+  }
+  for (const auto &role: benchmark->_roleResults) {
+    double wall_s = static_cast<double>(role.wall_ns) / 1000 / 1000 / 1000;
+    Columns roleColumns = status;
+    roleColumns["role-threads"] = std::to_string(role.threads);
+    roleColumns["role-ops/s"] = std::to_string(wall_s > 0 ? static_cast<double>(role.operations) / wall_s : 0);
+    roleColumns["role-p50 [ns]"] = std::to_string(std::llround(role.latencies.Percentile(50)));
+    roleColumns["role-p99 [ns]"] = std::to_string(std::llround(role.latencies.Percentile(99)));
+    roleColumns["role-max [ns]"] = std::to_string(role.latencies.Max());
+    ReportRow(benchmark->_name + " [" + role.name + "]", benchmark->_description, benchmark->_iterations, {}, {},
+              roleColumns);
+  }
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::string CSVReporter::Quote(const std::string &value) const {
+  if (value.find(_separator) == std::string::npos && value.find_first_of("\"\r\n") == std::string::npos) {
+    return value;
+  }
+  std::string quoted = "\"";
+  for (char c: value) {
+    if (c == '"') { quoted += '"'; }
+    quoted += c;
+  }
+  return quoted + '"';
+}
+
+// _____________________________________________________________________________________________________________________
+void CSVReporter::ReportResults(BenchmarkBase *benchmark, const std::string &name, const std::vector<Result> &results,
+                                const Columns &columns) {
   std::vector<uint64_t> cpuTimes_ns;
   std::vector<uint64_t> wallTimes_ns;
 
-  for (auto &res: benchmark->_results) {
+  for (auto &res: results) {
     if (res.wallTime.getNanoseconds() != 0) { wallTimes_ns.push_back(res.wallTime.getNanoseconds()); }
     if (res.cpuTime.getNanoseconds() != 0) { cpuTimes_ns.push_back(res.cpuTime.getNanoseconds()); }
   }
-  _stream << benchmark->_name << _separator << benchmark->_description << _separator << benchmark->_iterations
-          << _separator << timed::utils::min(cpuTimes_ns)
-          << _separator << timed::utils::max(cpuTimes_ns) << _separator << timed::utils::mean(cpuTimes_ns) << _separator
-          << timed::utils::median(cpuTimes_ns) << _separator
-          << timed::utils::medianAbsolutePercentError(cpuTimes_ns) << _separator << timed::utils::min(wallTimes_ns)
-          << _separator << timed::utils::max(wallTimes_ns) << _separator << timed::utils::mean(wallTimes_ns)
-          << _separator << timed::utils::median(wallTimes_ns) << _separator
-          << timed::utils::medianAbsolutePercentError(wallTimes_ns) << "\n";
-  _stream << std::flush;
+  ReportRow(name, benchmark->_description, benchmark->_iterations, cpuTimes_ns, wallTimes_ns, columns);
+}
+
+// _____________________________________________________________________________________________________________________
+void CSVReporter::ReportRow(const std::string &name, const std::string &description, uint64_t iterations,
+                            const std::vector<uint64_t> &cpuTimes_ns, const std::vector<uint64_t> &wallTimes_ns,
+                            const Columns &columns) {
+  auto summarize = [](const std::vector<uint64_t> &times_ns) {
+    return statistics::Summarize(std::vector<double>(times_ns.begin(), times_ns.end()));
+  };
+  auto cpu = summarize(cpuTimes_ns);
+  auto wall = summarize(wallTimes_ns);
+  Columns rowColumns = columns;
+  rowColumns["cpu-mean-ci-method"] = statistics::ToString(cpu.meanCI.method);
+  rowColumns["wall-mean-ci-method"] = statistics::ToString(wall.meanCI.method);
+  // the columns of the original format come first, the ones added later are appended for both time kinds
+  auto reportTimes = [this](const statistics::Summary &summary) {
+    if (summary.count == 0) {
+      _stream << _separator << _separator << _separator << _separator << _separator;
+      return;
+    }
+    _stream << _separator << summary.min << _separator << summary.max << _separator << summary.mean << _separator
+            << summary.median << _separator << summary.medianAbsolutePercentError;
+  };
+  auto reportExtended = [this](const statistics::Summary &summary) {
+    if (summary.count == 0) {
+      for (int i = 0; i < 8; ++i) { _stream << _separator; }
+      return;
+    }
+    _stream << _separator << summary.meanCI.low << _separator << summary.meanCI.high << _separator
+            << summary.medianCI.low << _separator << summary.medianCI.high << _separator << summary.stddev
+            << _separator << summary.Outliers() << _separator << summary.modes << _separator
+            << summary.autocorrelation;
+  };
+  _stream << Quote(name) << _separator << Quote(description) << _separator << iterations;
+  reportTimes(cpu);
+  reportTimes(wall);
+  reportExtended(cpu);
+  reportExtended(wall);
+  for (const auto *column: CSV_COLUMNS) {
+    auto it = rowColumns.find(column);
+    _stream << _separator << (it == rowColumns.end() ? "" : Quote(it->second));
+  }
+  _stream << "\n" << std::flush;
+}
+
+// ===== HistoryReporter ===============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void HistoryReporter::ReportInit(const std::string &launcherName) {
+  // all benchmarks of one run share the same timestamp
+  _timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// _____________________________________________________________________________________________________________________
+void HistoryReporter::ReportBenchmark(BenchmarkBase *benchmark) {
+  std::vector<double> cpuTimes_ns;
+  std::vector<double> wallTimes_ns;
+  for (const auto &res: benchmark->_results) {
+    auto wall = res.wallTime.getNanoseconds();
+    auto cpu = res.cpuTime.getNanoseconds();
+    if (wall != 0) { wallTimes_ns.push_back(static_cast<double>(wall)); }
+    if (cpu != 0) { cpuTimes_ns.push_back(static_cast<double>(cpu)); }
+  }
+  if (wallTimes_ns.empty()) { return; }
+  HistoryRecord record;
+  record.timestamp = _timestamp;
+  record.name = benchmark->_name;
+  record.gitSha = Environment::Get().gitSha;
+  record.iterations = benchmark->_iterations;
+  auto wall = statistics::Summarize(wallTimes_ns);
+  record.wallMin_ns = wall.min;
+  record.wallMean_ns = wall.mean;
+  record.wallMedian_ns = wall.median;
+  record.cpuMedian_ns = statistics::Summarize(cpuTimes_ns).median;
+  _store.Append(record);
 }
 
 // ===== CompareReporter ===============================================================================================
 // ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
 void CompareReporter::Report(std::vector<std::shared_ptr<BenchmarkBase>> &benchmarks) {
-  // TODO: implement
+  // groups in order of their first benchmark
+  std::vector<std::pair<std::string, std::vector<BenchmarkBase *>>> groups;
+  for (auto &bm: benchmarks) {
+    if (!bm->_launched || bm->_group.empty() || bm->_results.empty()) { continue; }
+    auto it = std::find_if(groups.begin(), groups.end(), [&](const auto &group) { return group.first == bm->_group; });
+    if (it == groups.end()) {
+      groups.push_back({bm->_group, {}});
+      it = groups.end() - 1;
+    }
+    it->second.push_back(bm.get());
+  }
+
+  auto summarizeWall_ms = [](const BenchmarkBase *bm) {
+    std::vector<double> times;
+    for (const auto &res: bm->_results) { times.push_back(res.wallTime.getMilliseconds()); }
+    return statistics::Summarize(times);
+  };
+
+  for (const auto &[group, members]: groups) {
+    std::vector<statistics::Summary> summaries;
+    double fastest = std::numeric_limits<double>::max();
+    std::size_t width = 12;
+    for (const auto *bm: members) {
+      summaries.push_back(summarizeWall_ms(bm));
+      fastest = std::min(fastest, summaries.back().median);
+      width = std::max(width, bm->_name.size() + 2);
+    }
+    // formatted in a local stream, so neither the alignment nor the precision of the relative column stick to _stream
+    std::ostringstream table;
+    std::string title = "--- COMPARISON: " + group + " ";
+    table << title << std::string(title.size() < 80 ? 80 - title.size() : 0, '-') << "\n"
+          << std::left << std::setw(static_cast<int>(width)) << "benchmark" << std::right << std::setw(16)
+          << "wall med [ms]" << std::setw(26) << "95% CI" << std::setw(12) << "relative" << "\n";
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      const auto &summary = summaries[i];
+      std::ostringstream relative;
+      relative << std::fixed << std::setprecision(2) << (fastest > 0 ? summary.median / fastest : 1) << "x";
+      std::ostringstream interval;
+      interval << "[" << summary.medianCI.low << ", " << summary.medianCI.high << "]";
+      table << std::left << std::setw(static_cast<int>(width)) << members[i]->_name << std::right << std::setw(16)
+            << summary.median << std::setw(26) << interval.str() << std::setw(12) << relative.str()
+            << (summary.median == fastest ? " (fastest)" : "") << "\n";
+    }
+    _stream << table.str();
+  }
+  _stream << std::flush;
 }
 
 }  // namespace benchmarked
\ No newline at end of file
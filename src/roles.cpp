@@ -0,0 +1,155 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "benchmarked/barrier.h"
+#include "benchmarked/roles.h"
+#include "timed/Timer.h"
+
+namespace benchmarked {
+
+// ===== RoleBenchmark =================================================================================================
+// ----- protected -----------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void RoleBenchmark::AddRole(const std::string &name, unsigned threads, std::function<void(unsigned)> body,
+                            uint64_t operations) {
+  if (threads == 0) {
+    throw std::invalid_argument("Role '" + name + "' of benchmark '" + _name + "' has no threads.");
+  }
+  _roles.push_back({name, threads, std::move(body), operations});
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void RoleBenchmark::Launch() {
+  SetUp();
+
+  _roles.clear();
+  DeclareRoles();
+  bool bounded = std::any_of(_roles.begin(), _roles.end(), [](const Role &role) { return role.operations > 0; });
+  if (_roles.empty() || (!bounded && _options.roleDuration.count() <= 0)) {
+    throw std::invalid_argument("Benchmark '" + _name + "' needs at least one role and a duration or an operation "
+                                "limit.");
+  }
+  _roleResults.clear();
+  for (const auto &role: _roles) {
+    _roleResults.push_back({role.name, role.threads, 0, 0, {}});
+  }
+
+  for (uint64_t iteration = 0; iteration < _iterations && !DeadlineReached(); ++iteration) {
+    Initialize();
+    _cleanUp();
+
+    auto armed = ArmWatchdog();
+    auto result = LaunchRound();
+    armed.Disarm();
+    Record([&]() { _results.push_back(result); });
+
+    Reset();
+  }
+
+  CleanUp();
+  _launched = true;
+}
+
+// _____________________________________________________________________________________________________________________
+Result RoleBenchmark::LaunchRound() {
+  struct RoleThread {
+    RoleThread(std::size_t role, unsigned index, uint64_t quota) : role(role), index(index), quota(quota) {}
+
+    std::size_t role;
+    unsigned index;
+    uint64_t quota;  // UINT64_MAX if the role has no operation limit
+    uint64_t operations = 0;
+    LatencyHistogram latencies;
+  };
+
+  std::vector<RoleThread> threads;
+  for (std::size_t r = 0; r < _roles.size(); ++r) {
+    const auto &role = _roles[r];
+    for (unsigned i = 0; i < role.threads; ++i) {
+      // the operations of a role are split evenly, so the threads do not contend on a shared counter
+      uint64_t quota = role.operations / role.threads + (i < role.operations % role.threads ? 1 : 0);
+      threads.emplace_back(r, i, role.operations > 0 ? quota : UINT64_MAX);
+    }
+  }
+
+  // the coordinating thread arrives last, after all role threads were started and the timers are running. Threads
+  //  started early spin for long enough to not park in the meantime, so all are released within a few microseconds.
+  Barrier startBarrier(threads.size() + 1, std::chrono::milliseconds(50));
+  std::atomic<bool> stop{false};
+  std::atomic<std::size_t> pendingBounded{0};
+  for (const auto &thread: threads) {
+    if (thread.quota != UINT64_MAX) { pendingBounded.fetch_add(1, std::memory_order_relaxed); }
+  }
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads.size());
+  for (auto &thread: threads) {
+    workers.emplace_back([&]() {
+      const auto &body = _roles[thread.role].body;
+      startBarrier.Wait();
+      try {
+        for (; thread.operations < thread.quota && !stop.load(std::memory_order_relaxed); ++thread.operations) {
+          auto start = std::chrono::steady_clock::now();
+          body(thread.index);
+          auto end = std::chrono::steady_clock::now();
+          thread.latencies.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+      } catch (...) {
+        std::unique_lock locker(errorMutex);
+        if (!error) { error = std::current_exception(); }
+        stop.store(true, std::memory_order_relaxed);
+      }
+      if (thread.quota != UINT64_MAX && pendingBounded.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        stop.store(true, std::memory_order_relaxed);
+      }
+    });
+  }
+  while (startBarrier.Waiting() < workers.size()) { std::this_thread::yield(); }
+
+  timed::WallTimer wall_timer;
+  timed::CPUTimer cpu_timer;
+  auto start = std::chrono::steady_clock::now();
+  wall_timer.start();
+  cpu_timer.start();
+  startBarrier.Wait();
+
+  auto deadline = _options.roleDuration.count() > 0 ? start + _options.roleDuration
+                                                    : std::chrono::steady_clock::time_point::max();
+  while (!stop.load(std::memory_order_relaxed)) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) { break; }
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                                             std::chrono::milliseconds(1)));
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto &worker: workers) { worker.join(); }
+
+  cpu_timer.stop();
+  wall_timer.stop();
+  int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+      .count();
+
+  if (error) { std::rethrow_exception(error); }
+  Record([&]() {
+    _startSkew_ns.push_back(startBarrier.Skew());
+    for (auto &roleResult: _roleResults) { roleResult.wall_ns += wall_ns; }
+    for (const auto &thread: threads) {
+      _roleResults[thread.role].operations += thread.operations;
+      _roleResults[thread.role].latencies.Merge(thread.latencies);
+    }
+  });
+  return {cpu_timer.getTime(), wall_timer.getTime()};
+}
+
+}  // namespace benchmarked
@@ -0,0 +1,379 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "benchmarked/statistics.h"
+
+namespace benchmarked::statistics {
+
+namespace {
+
+// The loops over all samples keep kLanes independent accumulators, so that they are vectorized without reordering
+//  floating point additions (which compilers only do with -ffast-math).
+constexpr std::size_t kLanes = 4;
+
+// _____________________________________________________________________________________________________________________
+double Sum(const std::vector<double>& values) {
+  std::array<double, kLanes> sum{};
+  std::size_t i = 0;
+  for (; i + kLanes <= values.size(); i += kLanes) {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) { sum[lane] += values[i + lane]; }
+  }
+  for (; i < values.size(); ++i) { sum[0] += values[i]; }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+// _____________________________________________________________________________________________________________________
+// sums of the 2nd, 3rd and 4th powers of the deviations from mean and of the products of consecutive deviations
+struct Moments {
+  double m2 = 0;
+  double m3 = 0;
+  double m4 = 0;
+  double lag1 = 0;
+};
+
+Moments CentralMoments(const std::vector<double>& values, double mean) {
+  std::array<double, kLanes> m2{}, m3{}, m4{}, lag1{};
+  std::size_t i = 0;
+  for (; i + kLanes < values.size(); i += kLanes) {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      double d = values[i + lane] - mean;
+      double d2 = d * d;
+      m2[lane] += d2;
+      m3[lane] += d2 * d;
+      m4[lane] += d2 * d2;
+      lag1[lane] += d * (values[i + lane + 1] - mean);
+    }
+  }
+  for (; i < values.size(); ++i) {
+    double d = values[i] - mean;
+    double d2 = d * d;
+    m2[0] += d2;
+    m3[0] += d2 * d;
+    m4[0] += d2 * d2;
+    if (i + 1 < values.size()) { lag1[0] += d * (values[i + 1] - mean); }
+  }
+  auto reduce = [](const std::array<double, kLanes>& lanes) { return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]); };
+  return {reduce(m2), reduce(m3), reduce(m4), reduce(lag1)};
+}
+
+// _____________________________________________________________________________________________________________________
+// upper 64 bits of the 128 bit product a * b
+uint64_t MultiplyHigh(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+  const uint64_t aLow = a & 0xffffffffULL;
+  const uint64_t aHigh = a >> 32;
+  const uint64_t bLow = b & 0xffffffffULL;
+  const uint64_t bHigh = b >> 32;
+  const uint64_t low = aLow * bLow;
+  const uint64_t middle1 = aHigh * bLow + (low >> 32);
+  const uint64_t middle2 = aLow * bHigh + (middle1 & 0xffffffffULL);
+  return aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+// SplitMix64, much cheaper than std::mt19937_64 for the millions of draws of a bootstrap
+class FastRandom {
+ public:
+  explicit FastRandom(uint64_t seed) : _state(seed) {}
+
+  uint64_t Next() {
+    uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // uniform in [0, bound) using Lemire's multiply-shift reduction
+  std::size_t Below(std::size_t bound) {
+    return static_cast<std::size_t>(MultiplyHigh(Next(), bound));
+  }
+
+ private:
+  uint64_t _state;
+};
+
+// _____________________________________________________________________________________________________________________
+double NormalCDF(double x) {
+  return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+// _____________________________________________________________________________________________________________________
+double NormalQuantile(double p) {
+  double low = -10;
+  double high = 10;
+  for (int i = 0; i < 100; ++i) {
+    double mid = (low + high) / 2;
+    (NormalCDF(mid) < p ? low : high) = mid;
+  }
+  return (low + high) / 2;
+}
+
+// _____________________________________________________________________________________________________________________
+// P(X >= k) for X ~ Binomial(n, p): exact for small n, normal approximation with continuity correction otherwise
+double BinomialUpperTail(std::size_t n, double p, std::size_t k) {
+  if (k == 0 || p >= 1) { return 1; }
+  if (p <= 0) { return 0; }
+  auto nd = static_cast<double>(n);
+  if (n > 200) {
+    return 0.5 * std::erfc((static_cast<double>(k) - 0.5 - nd * p) / std::sqrt(2 * nd * p * (1 - p)));
+  }
+  double tail = 0;
+  for (std::size_t i = k; i <= n; ++i) {
+    auto id = static_cast<double>(i);
+    tail += std::exp(std::lgamma(nd + 1) - std::lgamma(id + 1) - std::lgamma(nd - id + 1) + id * std::log(p) +
+                     (nd - id) * std::log1p(-p));
+  }
+  return std::min(tail, 1.0);
+}
+
+// _____________________________________________________________________________________________________________________
+// Exact bootstrap distribution of the sample median (Efron 1979): the median of a resample is <= sorted[j - 1] iff at
+//  least half of the n draws hit one of the j smallest samples, i.e. with probability P(Binomial(n, j / n) >= n / 2).
+Estimate MedianCI(const std::vector<double>& sorted, double confidence) {
+  Estimate estimate;
+  estimate.confidence = confidence;
+  estimate.value = PercentileSorted(sorted, 50);
+  std::size_t n = sorted.size();
+  std::size_t half = (n + 1) / 2;
+  auto quantileIndex = [&](double q) {
+    std::size_t low = 1;
+    std::size_t high = n;
+    while (low < high) {
+      std::size_t mid = (low + high) / 2;
+      if (BinomialUpperTail(n, static_cast<double>(mid) / static_cast<double>(n), half) >= q) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    return low - 1;
+  };
+  estimate.method = IntervalMethod::ExactBootstrap;
+  estimate.low = sorted[quantileIndex((1 - confidence) / 2)];
+  estimate.high = sorted[quantileIndex((1 + confidence) / 2)];
+  return estimate;
+}
+
+// _____________________________________________________________________________________________________________________
+Estimate MeanCI(const std::vector<double>& samples, double mean, double stddev, double confidence, unsigned resamples) {
+  Estimate estimate;
+  estimate.confidence = confidence;
+  estimate.value = mean;
+  std::size_t n = samples.size();
+  if (static_cast<double>(n) * resamples > static_cast<double>(1ULL << 25)) {
+    double margin = NormalQuantile((1 + confidence) / 2) * stddev / std::sqrt(static_cast<double>(n));
+    estimate.method = IntervalMethod::NormalApproximation;
+    estimate.low = mean - margin;
+    estimate.high = mean + margin;
+    return estimate;
+  }
+  FastRandom rng(n);
+  std::vector<double> means(resamples);
+  for (auto& resampledMean: means) {
+    std::array<double, kLanes> sum{};
+    std::size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+      for (std::size_t lane = 0; lane < kLanes; ++lane) { sum[lane] += samples[rng.Below(n)]; }
+    }
+    for (; i < n; ++i) { sum[0] += samples[rng.Below(n)]; }
+    resampledMean = ((sum[0] + sum[1]) + (sum[2] + sum[3])) / static_cast<double>(n);
+  }
+  std::sort(means.begin(), means.end());
+  estimate.method = IntervalMethod::PercentileBootstrap;
+  estimate.low = PercentileSorted(means, (1 - confidence) / 2 * 100);
+  estimate.high = PercentileSorted(means, (1 + confidence) / 2 * 100);
+  return estimate;
+}
+
+// _____________________________________________________________________________________________________________________
+// Number of modes of a gaussian kernel density estimate (Silverman's bandwidth) on a grid between the outer fences.
+//  Peaks below 10% of the highest one and peaks not separated by a valley of at least 20% are not counted.
+unsigned CountModes(const std::vector<double>& sorted, const Summary& summary) {
+  constexpr std::size_t kGrid = 256;
+  double iqr = summary.q3 - summary.q1;
+  double lower = std::max(summary.min, summary.q1 - 3 * iqr);
+  double upper = std::min(summary.max, summary.q3 + 3 * iqr);
+  double spread = iqr > 0 ? std::min(summary.stddev, iqr / 1.34) : summary.stddev;
+  double bandwidth = 0.9 * spread * std::pow(static_cast<double>(sorted.size()), -0.2);
+  if (upper <= lower || bandwidth <= 0) { return 1; }
+
+  // linear binning
+  double binWidth = (upper - lower) / (kGrid - 1);
+  std::vector<double> counts(kGrid, 0);
+  for (auto it = std::lower_bound(sorted.begin(), sorted.end(), lower); it != sorted.end() && *it <= upper; ++it) {
+    double position = (*it - lower) / binWidth;
+    auto bin = std::min(static_cast<std::size_t>(position), kGrid - 2);
+    double fraction = position - static_cast<double>(bin);
+    counts[bin] += 1 - fraction;
+    counts[bin + 1] += fraction;
+  }
+
+  double bandwidthBins = bandwidth / binWidth;
+  auto radius = static_cast<std::size_t>(std::min(std::ceil(4 * bandwidthBins), static_cast<double>(kGrid - 1)));
+  std::vector<double> kernel(radius + 1);
+  for (std::size_t k = 0; k <= radius; ++k) {
+    double x = static_cast<double>(k) / bandwidthBins;
+    kernel[k] = std::exp(-0.5 * x * x);
+  }
+  std::vector<double> density(kGrid, 0);
+  for (std::size_t g = 0; g < kGrid; ++g) {
+    double value = counts[g] * kernel[0];
+    for (std::size_t k = 1; k <= radius; ++k) {
+      if (g >= k) { value += counts[g - k] * kernel[k]; }
+      if (g + k < kGrid) { value += counts[g + k] * kernel[k]; }
+    }
+    density[g] = value;
+  }
+
+  double highest = *std::max_element(density.begin(), density.end());
+  std::vector<double> peaks;
+  double valley = highest;
+  for (std::size_t g = 0; g < kGrid; ++g) {
+    valley = std::min(valley, density[g]);
+    bool isPeak = (g == 0 || density[g] > density[g - 1]) && (g + 1 == kGrid || density[g] >= density[g + 1]);
+    if (!isPeak || density[g] < 0.1 * highest) { continue; }
+    if (peaks.empty() || valley < 0.8 * std::min(peaks.back(), density[g])) {
+      peaks.push_back(density[g]);
+    } else {
+      peaks.back() = std::max(peaks.back(), density[g]);
+    }
+    valley = density[g];
+  }
+  return std::max<unsigned>(1, static_cast<unsigned>(peaks.size()));
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+const char* ToString(IntervalMethod method) {
+  switch (method) {
+    case IntervalMethod::ExactBootstrap: return "exact bootstrap";
+    case IntervalMethod::PercentileBootstrap: return "percentile bootstrap";
+    case IntervalMethod::NormalApproximation: return "normal approximation";
+    default: return "";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+Summary Summarize(const std::vector<double>& samples, double confidence, unsigned resamples) {
+  Summary summary;
+  summary.count = samples.size();
+  if (samples.empty()) { return summary; }
+
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+  auto n = static_cast<double>(samples.size());
+  summary.min = sorted.front();
+  summary.max = sorted.back();
+  summary.mean = Sum(samples) / n;
+  summary.median = PercentileSorted(sorted, 50);
+  summary.q1 = PercentileSorted(sorted, 25);
+  summary.q3 = PercentileSorted(sorted, 75);
+
+  auto moments = CentralMoments(samples, summary.mean);
+  summary.stddev = samples.size() > 1 ? std::sqrt(moments.m2 / (n - 1)) : 0;
+  if (moments.m2 > 0) {
+    summary.autocorrelation = moments.lag1 / moments.m2;
+    double g1 = (moments.m3 / n) / std::pow(moments.m2 / n, 1.5);
+    double g2 = (moments.m4 / n) / std::pow(moments.m2 / n, 2) - 3;
+    summary.skewness = g1;
+    summary.kurtosis = g2;
+    if (samples.size() > 3) {
+      // small sample corrected skewness and excess kurtosis as used by the bimodality coefficient
+      double skew = g1 * std::sqrt(n * (n - 1)) / (n - 2);
+      double kurt = ((n + 1) * g2 + 6) * (n - 1) / ((n - 2) * (n - 3));
+      summary.bimodalityCoefficient = (skew * skew + 1) / (kurt + 3 * (n - 1) * (n - 1) / ((n - 2) * (n - 3)));
+    }
+  }
+
+  if (summary.median != 0) {
+    std::vector<double> deviations(samples.size());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      deviations[i] = std::abs(samples[i] - summary.median) / std::abs(summary.median) * 100;
+    }
+    // the median of the deviations only needs a selection, not a second full sort
+    auto middle = deviations.begin() + static_cast<std::ptrdiff_t>(deviations.size() / 2);
+    std::nth_element(deviations.begin(), middle, deviations.end());
+    summary.medianAbsolutePercentError = *middle;
+    if (deviations.size() % 2 == 0) {
+      summary.medianAbsolutePercentError =
+          (summary.medianAbsolutePercentError + *std::max_element(deviations.begin(), middle)) / 2;
+    }
+  }
+
+  double iqr = summary.q3 - summary.q1;
+  auto countBelow = [&](double value) {
+    return static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+  };
+  auto countAbove = [&](double value) {
+    return static_cast<std::size_t>(sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), value));
+  };
+  summary.lowSevere = countBelow(summary.q1 - 3 * iqr);
+  summary.lowMild = countBelow(summary.q1 - 1.5 * iqr) - summary.lowSevere;
+  summary.highSevere = countAbove(summary.q3 + 3 * iqr);
+  summary.highMild = countAbove(summary.q3 + 1.5 * iqr) - summary.highSevere;
+
+  summary.medianCI = MedianCI(sorted, confidence);
+  summary.meanCI = MeanCI(samples, summary.mean, summary.stddev, confidence, resamples);
+  summary.modes = CountModes(sorted, summary);
+  return summary;
+}
+
+// _____________________________________________________________________________________________________________________
+double Percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  return PercentileSorted(values, p);
+}
+
+// _____________________________________________________________________________________________________________________
+double PercentileSorted(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) { return 0; }
+  double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1);
+  auto lower = static_cast<std::size_t>(std::floor(rank));
+  auto upper = static_cast<std::size_t>(std::ceil(rank));
+  return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - static_cast<double>(lower));
+}
+
+// _____________________________________________________________________________________________________________________
+Estimate BootstrapPairedRatio(const std::vector<double>& a, const std::vector<double>& b, double confidence,
+                              unsigned resamples) {
+  Estimate estimate;
+  estimate.confidence = confidence;
+  std::vector<double> logRatios;
+  for (std::size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+    if (a[i] > 0 && b[i] > 0) { logRatios.push_back(std::log(b[i] / a[i])); }
+  }
+  if (logRatios.empty()) { return estimate; }
+
+  auto meanOf = [](const std::vector<double>& values) {
+    double sum = 0;
+    for (double value: values) { sum += value; }
+    return sum / static_cast<double>(values.size());
+  };
+  estimate.value = std::exp(meanOf(logRatios));
+
+  std::mt19937_64 rng(logRatios.size());
+  std::uniform_int_distribution<std::size_t> pick(0, logRatios.size() - 1);
+  std::vector<double> means(resamples);
+  for (auto& mean: means) {
+    double sum = 0;
+    for (std::size_t i = 0; i < logRatios.size(); ++i) { sum += logRatios[pick(rng)]; }
+    mean = sum / static_cast<double>(logRatios.size());
+  }
+  std::sort(means.begin(), means.end());
+  estimate.method = IntervalMethod::PercentileBootstrap;
+  estimate.low = std::exp(PercentileSorted(means, (1 - confidence) / 2 * 100));
+  estimate.high = std::exp(PercentileSorted(means, (1 + confidence) / 2 * 100));
+  return estimate;
+}
+
+}  // namespace benchmarked::statistics
@@ -0,0 +1,65 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include "benchmarked/watchdog.h"
+
+namespace benchmarked {
+
+// ===== Watchdog ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Watchdog::Watchdog(std::function<void()> onExpired) : _onExpired(std::move(onExpired)) {}
+
+// _____________________________________________________________________________________________________________________
+Watchdog::~Watchdog() {
+  {
+    std::unique_lock lock(_mutex);
+    _stop = true;
+  }
+  _condVar.notify_all();
+  if (_thread.joinable()) { _thread.join(); }
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t Watchdog::Arm(Clock::time_point deadline) {
+  uint64_t generation = 0;
+  {
+    std::unique_lock lock(_mutex);
+    _deadline = deadline;
+    generation = ++_generation;
+    if (!_thread.joinable()) {
+      _thread = std::thread(&Watchdog::Loop, this);
+    }
+  }
+  _condVar.notify_all();
+  return generation;
+}
+
+// _____________________________________________________________________________________________________________________
+void Watchdog::Disarm(uint64_t generation) {
+  std::unique_lock lock(_mutex);
+  if (generation != _generation) { return; }
+  _deadline = Clock::time_point::max();
+  ++_generation;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void Watchdog::Loop() {
+  std::unique_lock lock(_mutex);
+  while (!_stop) {
+    if (_deadline == Clock::time_point::max()) {
+      _condVar.wait(lock);
+      continue;
+    }
+    uint64_t generation = _generation;
+    _condVar.wait_until(lock, _deadline);
+    // expired only if the deadline waited for was neither disarmed nor replaced in the meantime
+    if (!_stop && generation == _generation && Clock::now() >= _deadline) {
+      _deadline = Clock::time_point::max();
+      _onExpired();
+    }
+  }
+}
+
+}  // namespace benchmarked
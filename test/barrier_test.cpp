@@ -0,0 +1,70 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/barrier.h"
+
+using benchmarked::Barrier;
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+// every thread passes the barrier generations times, each arrival is counted before it waits
+void passGenerations(Barrier &barrier, unsigned threads, unsigned generations) {
+  std::atomic<unsigned> arrivals{0};
+  std::atomic<unsigned> last{0};
+  std::atomic<bool> early{false};
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      for (unsigned generation = 0; generation < generations; ++generation) {
+        // stagger the arrivals, so some threads spin and some park
+        if ((generation + t) % 4 == 0) { std::this_thread::sleep_for(std::chrono::microseconds(200)); }
+        arrivals.fetch_add(1);
+        if (barrier.Wait()) { last.fetch_add(1); }
+        // nobody leaves a generation before all threads have arrived at it
+        if (arrivals.load() < threads * (generation + 1)) { early = true; }
+      }
+    });
+  }
+  for (auto &worker: workers) { worker.join(); }
+  EXPECT_FALSE(early);
+  EXPECT_EQ(last, generations);
+  EXPECT_EQ(barrier.Waiting(), 0);
+  EXPECT_GE(barrier.Skew(), 0);
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(Barrier, SingleThread) {
+  Barrier barrier(1);
+  EXPECT_TRUE(barrier.Wait());
+  EXPECT_TRUE(barrier.Wait());
+  EXPECT_EQ(barrier.Waiting(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Barrier, ReusedAcrossGenerations) {
+  Barrier barrier(4);
+  passGenerations(barrier, 4, 200);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Barrier, ReusedAcrossGenerationsWithoutSpinning) {
+  Barrier barrier(4, std::chrono::nanoseconds(0));
+  passGenerations(barrier, 4, 200);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Barrier, MoreThreadsThanCores) {
+  unsigned threads = std::thread::hardware_concurrency() * 2 + 1;
+  Barrier barrier(threads);
+  passGenerations(barrier, threads, 20);
+}
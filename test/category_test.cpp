@@ -0,0 +1,115 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/category.h"
+
+using benchmarked::Categories;
+using benchmarked::Category;
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+std::string writeSelection(const std::string &name, const std::string &selection, std::filesystem::perms perms) {
+  std::string path = ::testing::TempDir() + name;
+  std::filesystem::remove(path);
+  std::ofstream(path) << selection;
+  std::filesystem::permissions(path, perms);
+  return path;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(Category, SelectionKeepsTheLastRulePerName) {
+  Category storage("storage");
+  Category net("net");
+
+  Categories::Select("storage,net,-storage");
+  EXPECT_EQ(Categories::Selection(), "net,-storage");
+  EXPECT_FALSE(storage.Enabled());
+  EXPECT_TRUE(net.Enabled());
+
+  for (int i = 0; i < 1000; ++i) {
+    Categories::Enable("storage");
+    Categories::Disable("storage");
+  }
+  EXPECT_EQ(Categories::Selection(), "net,-storage");
+
+  // "all" and "none" override every rule before them
+  Categories::Enable("all");
+  Categories::Disable("net");
+  EXPECT_EQ(Categories::Selection(), "all,-net");
+  EXPECT_TRUE(storage.Enabled());
+  EXPECT_FALSE(net.Enabled());
+  Categories::Select("storage,none");
+  EXPECT_EQ(Categories::Selection(), "none");
+  EXPECT_FALSE(storage.Enabled());
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Category, LaterDeclaredCategoriesFollowTheSelection) {
+  Categories::Select("all,-late");
+  Category late("late");
+  Category other("other");
+  EXPECT_FALSE(late.Enabled());
+  EXPECT_TRUE(other.Enabled());
+  Categories::Select("none");
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Category, LoadsOnlyPrivateFilesOfTheUser) {
+  namespace fs = std::filesystem;
+  Category loaded("loaded");
+  Categories::Select("none");
+
+  auto readable = writeSelection("categories_readable", "loaded", fs::perms::owner_read | fs::perms::owner_write |
+                                                                  fs::perms::others_read);
+  EXPECT_FALSE(Categories::Load(readable));
+  auto writable = writeSelection("categories_writable", "loaded", fs::perms::owner_read | fs::perms::owner_write |
+                                                                  fs::perms::group_write);
+  EXPECT_FALSE(Categories::Load(writable));
+  EXPECT_FALSE(Categories::Load(::testing::TempDir() + "categories_missing"));
+  EXPECT_FALSE(Categories::Load(::testing::TempDir()));
+  EXPECT_FALSE(loaded.Enabled());
+
+  auto secure = writeSelection("categories_secure", "loaded\n", fs::perms::owner_read | fs::perms::owner_write);
+  std::string link = ::testing::TempDir() + "categories_link";
+  fs::remove(link);
+  fs::create_symlink(secure, link);
+  EXPECT_FALSE(Categories::Load(link));
+  EXPECT_FALSE(loaded.Enabled());
+
+  EXPECT_TRUE(Categories::Load(secure));
+  EXPECT_TRUE(loaded.Enabled());
+
+  Categories::Select("none");
+  for (const auto &path: {readable, writable, secure, link}) { fs::remove(path); }
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Category, SignalLoadsTheSelection) {
+  Category signaled("signaled");
+  Categories::Select("none");
+  auto path = writeSelection("categories_signal", "signaled", std::filesystem::perms::owner_read |
+                                                              std::filesystem::perms::owner_write);
+  Categories::InstallSignalHandler(path);
+
+  std::raise(SIGUSR2);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!signaled.Enabled() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(signaled.Enabled());
+
+  Categories::Select("none");
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,182 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/calibration.h"
+#include "benchmarked/checkpoint.h"
+#include "benchmarked/environment.h"
+#include "benchmarked/reporter.h"
+
+using benchmarked::BenchmarkBase;
+using benchmarked::Checkpoint;
+using benchmarked::Result;
+
+namespace {
+
+/**
+ * FixedBenchmark: a launched benchmark with given wall times.
+ */
+class FixedBenchmark : public BenchmarkBase {
+ public:
+  FixedBenchmark(const std::string &name, const std::vector<uint64_t> &wallTimes_ns)
+    : BenchmarkBase(name, "type", "description, with separator", wallTimes_ns.size(), nullptr) {
+    for (auto wall_ns: wallTimes_ns) {
+      _results.emplace_back(timed::Time(std::chrono::nanoseconds(wall_ns / 2)),
+                            timed::Time(std::chrono::nanoseconds(wall_ns)));
+    }
+    _launched = true;
+  }
+
+  void Launch() override {}
+};
+
+// _____________________________________________________________________________________________________________________
+std::string checkpointPath(const std::string &name) {
+  auto path = ::testing::TempDir() + "benchmarked_checkpoint_test_" + name;
+  std::filesystem::remove(path);
+  return path;
+}
+
+// _____________________________________________________________________________________________________________________
+// CSV rows of benchmarks, the header is left out
+std::string csv(const std::vector<std::shared_ptr<BenchmarkBase>> &benchmarks) {
+  std::ostringstream os;
+  benchmarked::CSVReporter reporter(os);
+  for (const auto &benchmark: benchmarks) { reporter.ReportBenchmark(benchmark.get()); }
+  return os.str();
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(Checkpoint, RoundTrip) {
+  auto path = checkpointPath("round_trip");
+  std::vector<std::shared_ptr<BenchmarkBase>> appended = {
+      std::make_shared<FixedBenchmark>("first", std::vector<uint64_t>{1000, 2000, 3000}),
+      std::make_shared<FixedBenchmark>("second\nline", std::vector<uint64_t>{5000})};
+  {
+    Checkpoint checkpoint(path);
+    for (const auto &benchmark: appended) { checkpoint.Append(*benchmark); }
+  }
+  auto loaded = Checkpoint::Load(path);
+  ASSERT_EQ(loaded.size(), 2);
+  EXPECT_EQ(csv(loaded), csv(appended));
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Checkpoint, LaterRecordReplacesEarlier) {
+  auto path = checkpointPath("replace");
+  {
+    Checkpoint checkpoint(path);
+    checkpoint.Append(FixedBenchmark("a", {1000}));
+    checkpoint.Append(FixedBenchmark("b", {2000}));
+    checkpoint.Append(FixedBenchmark("a", {3000}));
+  }
+  auto loaded = Checkpoint::Load(path);
+  ASSERT_EQ(loaded.size(), 2);
+  EXPECT_EQ(csv(loaded), csv({std::make_shared<FixedBenchmark>("a", std::vector<uint64_t>{3000}),
+                              std::make_shared<FixedBenchmark>("b", std::vector<uint64_t>{2000})}));
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Checkpoint, RecoversFromTruncatedTail) {
+  auto path = checkpointPath("truncated_tail");
+  {
+    Checkpoint checkpoint(path);
+    checkpoint.Append(FixedBenchmark("a", {1000}));
+    checkpoint.Append(FixedBenchmark("b", {2000, 4000}));
+  }
+  // a crash in the middle of the second append
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  EXPECT_EQ(Checkpoint::Load(path).size(), 1);
+  {
+    // opening for appending removes the partial record
+    Checkpoint checkpoint(path);
+    checkpoint.Append(FixedBenchmark("c", {3000}));
+  }
+  auto loaded = Checkpoint::Load(path);
+  ASSERT_EQ(loaded.size(), 2);
+  EXPECT_EQ(csv(loaded), csv({std::make_shared<FixedBenchmark>("a", std::vector<uint64_t>{1000}),
+                              std::make_shared<FixedBenchmark>("c", std::vector<uint64_t>{3000})}));
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Checkpoint, Merge) {
+  auto first = checkpointPath("merge_first");
+  auto second = checkpointPath("merge_second");
+  {
+    Checkpoint checkpoint(first);
+    checkpoint.Append(FixedBenchmark("a", {1000}));
+    checkpoint.Append(FixedBenchmark("b", {2000}));
+  }
+  {
+    Checkpoint checkpoint(second);
+    checkpoint.Append(FixedBenchmark("b", {4000}));
+    checkpoint.Append(FixedBenchmark("c", {3000}));
+  }
+  auto merged = Checkpoint::Merge({first, second});
+  ASSERT_EQ(merged.size(), 3);
+  EXPECT_EQ(csv(merged), csv({std::make_shared<FixedBenchmark>("a", std::vector<uint64_t>{1000}),
+                              std::make_shared<FixedBenchmark>("b", std::vector<uint64_t>{4000}),
+                              std::make_shared<FixedBenchmark>("c", std::vector<uint64_t>{3000})}));
+  EXPECT_THROW(Checkpoint::Merge({checkpointPath("missing")}), std::runtime_error);
+  std::filesystem::remove(first);
+  std::filesystem::remove(second);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Checkpoint, RecordsTheEnvironmentOfTheWriter) {
+  auto path = checkpointPath("environment");
+  {
+    Checkpoint checkpoint(path);
+    EXPECT_TRUE(Checkpoint::LoadEnvironment(path).Empty());
+    checkpoint.Append(FixedBenchmark("a", {1000}));
+  }
+  auto recorded = Checkpoint::LoadEnvironment(path);
+  EXPECT_EQ(recorded.entries, benchmarked::Environment::Get().Entries());
+  EXPECT_EQ(recorded.hostProfile, benchmarked::HostProfile::Get().Metrics());
+  {
+    // written once, by the process that wrote the first record
+    Checkpoint checkpoint(path);
+    checkpoint.Append(FixedBenchmark("b", {2000}));
+  }
+  EXPECT_EQ(Checkpoint::LoadEnvironment(path).entries, recorded.entries);
+  EXPECT_EQ(Checkpoint::Load(path).size(), 2);
+
+  // a crash while the header and the first record were written
+  std::filesystem::resize_file(path, 40);
+  EXPECT_TRUE(Checkpoint::Load(path).empty());
+  EXPECT_TRUE(Checkpoint::LoadEnvironment(path).Empty());
+  {
+    Checkpoint checkpoint(path);
+    checkpoint.Append(FixedBenchmark("c", {3000}));
+  }
+  EXPECT_EQ(Checkpoint::LoadEnvironment(path).hostProfile, recorded.hostProfile);
+  EXPECT_EQ(Checkpoint::Load(path).size(), 1);
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(RecordedEnvironment, Differences) {
+  benchmarked::RecordedEnvironment reference{{{"cpu model", "a"}, {"kernel", "6.1"}},
+                                             {{"copy bandwidth [GB/s]", 10}, {"syscall [ns]", 100}}};
+  EXPECT_TRUE(reference.Differences(reference, 0).empty());
+
+  benchmarked::RecordedEnvironment other{{{"cpu model", "b"}, {"$OMP_NUM_THREADS", "4"}},
+                                         {{"copy bandwidth [GB/s]", 10.5}, {"syscall [ns]", 150}}};
+  auto differences = other.Differences(reference, 0.1);
+  EXPECT_EQ(differences, (std::vector<std::string>{"cpu model: b (reference a)", "kernel: missing (reference 6.1)",
+                                                   "$OMP_NUM_THREADS: 4 (reference missing)",
+                                                   "syscall [ns]: 150 (reference 100, +50%)"}));
+  // the bandwidth deviates by 5%, within a tolerance of 10% but not of 1%
+  EXPECT_EQ(other.Differences(reference, 0.01).size(), 5);
+}
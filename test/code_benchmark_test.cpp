@@ -0,0 +1,64 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/benchmark.h"
+
+using benchmarked::CodeBenchmarkThreadWall;
+using benchmarked::CodeBenchmarkWall;
+
+// the scopes are static like the ones of the CodeBenchmarkHandler: they must outlive the threads that used them
+
+// _____________________________________________________________________________________________________________________
+TEST(CodeBenchmark, RecordsClosedIntervals) {
+  static CodeBenchmarkWall scope;
+  for (int i = 0; i < 3; ++i) {
+    scope.start(true);
+    scope.stop(true);
+  }
+  EXPECT_EQ(scope.getHistogram().Count(), 3);
+  EXPECT_EQ(scope.getResults().size(), 1);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(CodeBenchmark, StrictMisuseThrows) {
+  static CodeBenchmarkThreadWall scope;
+  EXPECT_THROW(scope.stop(true), std::logic_error);
+  scope.start(true);
+  EXPECT_THROW(scope.start(true), std::logic_error);
+  scope.stop(true);
+  EXPECT_THROW(scope.stop(true), std::logic_error);
+  EXPECT_EQ(scope.getHistogram().Count(), 1);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(CodeBenchmark, LenientMisuseIsIgnored) {
+  static CodeBenchmarkThreadWall scope;
+  EXPECT_NO_THROW(scope.stop(false));
+  scope.start(true);
+  // the interval left open is dropped
+  EXPECT_NO_THROW(scope.start(false));
+  scope.stop(true);
+  EXPECT_EQ(scope.getHistogram().Count(), 1);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(CodeBenchmark, IntervalsArePerThread) {
+  static CodeBenchmarkThreadWall scope;
+  scope.start(true);
+  std::thread other([]() {
+    // the interval open on the main thread does not belong to this one
+    EXPECT_THROW(scope.stop(true), std::logic_error);
+    scope.start(true);
+    scope.stop(true);
+  });
+  other.join();
+  scope.stop(true);
+  EXPECT_EQ(scope.getHistogram().Count(), 2);
+  // the exited thread is folded into std::thread::id()
+  EXPECT_EQ(scope.getResults().size(), 2);
+}
@@ -0,0 +1,155 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/dataset.h"
+
+using benchmarked::Dataset;
+using benchmarked::DatasetKey;
+using benchmarked::DatasetOptions;
+using benchmarked::DatasetWriter;
+
+namespace {
+
+// written first, at offset 0
+struct Layout {
+  uint64_t valuesOffset;
+  uint64_t valuesCount;
+};
+
+/**
+ * DatasetTest: every test uses its own empty cache directory and counts how often the data is generated.
+ */
+class DatasetTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    _options.directory = ::testing::TempDir() + "benchmarked_dataset_test";
+    std::filesystem::remove_all(_options.directory);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(_options.directory); }
+
+  // a layout struct followed by count values 0, 1, 2, ... (more than the 1 MiB buffer of the writer if count is large)
+  Dataset::Generator Sequence(uint64_t count) {
+    return [this, count](DatasetWriter &writer) {
+      ++_generated;
+      Layout layout{};
+      writer.Write(&layout, 1);
+      std::vector<uint64_t> values(count);
+      std::iota(values.begin(), values.end(), 0);
+      layout.valuesOffset = writer.Write(values);
+      layout.valuesCount = count;
+      writer.Patch(0, &layout, sizeof(layout));
+    };
+  }
+
+  static void ExpectSequence(const Dataset &dataset, uint64_t count) {
+    const auto &layout = dataset.At<Layout>(0);
+    ASSERT_EQ(layout.valuesCount, count);
+    auto values = dataset.Get<uint64_t>(layout.valuesOffset, layout.valuesCount);
+    for (uint64_t i = 0; i < count; ++i) { ASSERT_EQ(values[i], i); }
+  }
+
+  DatasetOptions _options;
+  int _generated = 0;
+};
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, GeneratesOnceAndMapsTheCacheAfterwards) {
+  DatasetKey key{"sequence", 42, 1};
+  {
+    Dataset dataset(key, Sequence(1000), _options);
+    EXPECT_TRUE(dataset.Generated());
+    ExpectSequence(dataset, 1000);
+  }
+  Dataset first(key, Sequence(1000), _options);
+  Dataset second(key, Sequence(1000), _options);
+  EXPECT_EQ(_generated, 1);
+  EXPECT_FALSE(first.Generated());
+  EXPECT_FALSE(second.Generated());
+  EXPECT_EQ(first.Path(), second.Path());
+  ExpectSequence(first, 1000);
+  ExpectSequence(second, 1000);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, LargeDataBypassesTheBuffer) {
+  // 4 MiB of values and a patch of the layout after they were written to the file
+  Dataset dataset({"large", 1, 1}, Sequence(512 * 1024), _options);
+  ExpectSequence(dataset, 512 * 1024);
+  _options.populate = true;
+  Dataset mapped({"large", 1, 1}, Sequence(512 * 1024), _options);
+  EXPECT_FALSE(mapped.Generated());
+  ExpectSequence(mapped, 512 * 1024);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, EveryKeyHasItsOwnData) {
+  Dataset data({"sequence", 1, 1}, Sequence(10), _options);
+  Dataset otherSeed({"sequence", 2, 1}, Sequence(20), _options);
+  Dataset otherVersion({"sequence", 1, 2}, Sequence(30), _options);
+  Dataset otherGenerator({"sequence/other", 1, 1}, Sequence(40), _options);
+  EXPECT_EQ(_generated, 4);
+  ExpectSequence(data, 10);
+  ExpectSequence(otherSeed, 20);
+  ExpectSequence(otherVersion, 30);
+  ExpectSequence(otherGenerator, 40);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, RejectsTruncatedCache) {
+  DatasetKey key{"truncated", 7, 1};
+  std::string path = Dataset(key, Sequence(100), _options).Path();
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(uint64_t));
+  Dataset regenerated(key, Sequence(100), _options);
+  EXPECT_TRUE(regenerated.Generated());
+  ExpectSequence(regenerated, 100);
+
+  // shorter than the header
+  std::filesystem::resize_file(path, 16);
+  Dataset again(key, Sequence(100), _options);
+  EXPECT_TRUE(again.Generated());
+  ExpectSequence(again, 100);
+  EXPECT_EQ(_generated, 3);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, RejectsStaleCache) {
+  DatasetKey key{"stale", 7, 3};
+  std::string path = Dataset(key, Sequence(100), _options).Path();
+
+  // a file of an older format (magic) or an unfinished one (complete flag) at the path of the key
+  for (std::streamoff offset: {0, 20}) {
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(offset);
+      file.put('\x7f');
+    }
+    Dataset regenerated(key, Sequence(100), _options);
+    EXPECT_TRUE(regenerated.Generated()) << offset;
+    ExpectSequence(regenerated, 100);
+  }
+  EXPECT_EQ(_generated, 3);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST_F(DatasetTest, GetChecksTheRange) {
+  Dataset dataset({"range", 1, 1}, Sequence(10), _options);
+  const auto &layout = dataset.At<Layout>(0);
+  EXPECT_EQ(dataset.Size(), layout.valuesOffset + 10 * sizeof(uint64_t));
+  EXPECT_NO_THROW(static_cast<void>(dataset.Get<uint64_t>(layout.valuesOffset, 10)));
+  EXPECT_THROW(static_cast<void>(dataset.Get<uint64_t>(layout.valuesOffset, 11)), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(dataset.Get<uint64_t>(layout.valuesOffset + 1, 1)), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(dataset.Get<char>(dataset.Size() + 1, 0)), std::out_of_range);
+}
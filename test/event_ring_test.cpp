@@ -0,0 +1,105 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/event_ring.h"
+
+using benchmarked::EventRing;
+using benchmarked::EventRingReader;
+
+namespace {
+
+constexpr uint32_t kMaxThreads = 2;
+constexpr uint32_t kCapacity = 8;
+
+// _____________________________________________________________________________________________________________________
+// the ring of this process is shared by all tests, every test starts its reader at the current end of the rings
+EventRing *eventRing() {
+  static EventRing *eventRing = EventRing::Enable(::testing::TempDir() + "benchmarked_event_ring_test", kMaxThreads,
+                                                  kCapacity, 16);
+  return eventRing;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(EventRing, ReaderCatchesUp) {
+  auto *ring = eventRing();
+  auto id = ring->NameId("wall", "catch up");
+  EventRingReader reader(ring->Path());
+  reader.Poll();
+  uint64_t dropped = reader.Dropped();
+
+  for (uint64_t duration = 1; duration <= 5; ++duration) { ring->Publish(id, duration); }
+  auto events = reader.Poll();
+  ASSERT_EQ(events.size(), 5);
+  for (uint64_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].nameId, id);
+    EXPECT_EQ(events[i].duration_ns, i + 1);
+    if (i > 0) { EXPECT_GE(events[i].end_ns, events[i - 1].end_ns); }
+  }
+  EXPECT_TRUE(reader.Poll().empty());
+  ring->Publish(id, 6);
+  events = reader.Poll();
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events.front().duration_ns, 6);
+  EXPECT_EQ(reader.Dropped(), dropped);
+  EXPECT_EQ(reader.Name(id), "wall:catch up");
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(EventRing, WrapsAroundAndCountsDropped) {
+  auto *ring = eventRing();
+  auto id = ring->NameId("wall", "wraparound");
+  EventRingReader reader(ring->Path());
+  reader.Poll();
+  uint64_t dropped = reader.Dropped();
+
+  // the producer never waits: the oldest events are overwritten and the reader skips to the oldest one left
+  for (uint64_t duration = 1; duration <= 2 * kCapacity + 3; ++duration) { ring->Publish(id, duration); }
+  auto events = reader.Poll();
+  ASSERT_EQ(events.size(), kCapacity);
+  for (uint64_t i = 0; i < kCapacity; ++i) { EXPECT_EQ(events[i].duration_ns, kCapacity + 4 + i); }
+  EXPECT_EQ(reader.Dropped(), dropped + kCapacity + 3);
+
+  // the reader continues right after the last event it read
+  ring->Publish(id, 100);
+  events = reader.Poll();
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events.front().duration_ns, 100);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(EventRing, ExitedThreadsReleaseTheirRings) {
+  auto *ring = eventRing();
+  auto id = ring->NameId("wall", "threads");
+  EventRingReader reader(ring->Path());
+  reader.Poll();
+  uint64_t dropped = reader.Dropped();
+
+  // more threads than rings, one after the other
+  for (uint32_t thread = 0; thread < 4 * kMaxThreads; ++thread) {
+    std::thread([ring, id, thread]() { ring->Publish(id, thread); }).join();
+  }
+  auto events = reader.Poll();
+  EXPECT_EQ(events.size(), 4 * kMaxThreads);
+  EXPECT_EQ(reader.Dropped(), dropped);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(EventRing, NewReaderStartsWithTheEventsStillInTheRings) {
+  auto *ring = eventRing();
+  auto id = ring->NameId("wall", "new reader");
+  for (uint64_t duration = 1; duration <= kCapacity; ++duration) { ring->Publish(id, duration); }
+  EventRingReader reader(ring->Path());
+  std::vector<uint64_t> durations;
+  for (const auto &event: reader.Poll()) {
+    if (event.nameId == id) { durations.push_back(event.duration_ns); }
+  }
+  ASSERT_EQ(durations.size(), kCapacity);
+  for (uint64_t i = 0; i < kCapacity; ++i) { EXPECT_EQ(durations[i], i + 1); }
+}
@@ -0,0 +1,103 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/benchmark.h"
+#include "benchmarked/exporter.h"
+
+using benchmarked::CodeBenchmarkHandler;
+using benchmarked::MetricsExporter;
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+// lines of exposition starting with prefix
+std::vector<std::string> linesStartingWith(const std::string &exposition, const std::string &prefix) {
+  std::vector<std::string> lines;
+  std::istringstream stream(exposition);
+  for (std::string line; std::getline(stream, line);) {
+    if (line.rfind(prefix, 0) == 0) { lines.push_back(line); }
+  }
+  return lines;
+}
+
+// _____________________________________________________________________________________________________________________
+double value(const std::string &line) {
+  return std::stod(line.substr(line.rfind(' ') + 1));
+}
+
+// _____________________________________________________________________________________________________________________
+double bound(const std::string &line) {
+  auto start = line.find("le=\"") + 4;
+  auto bound = line.substr(start, line.find('"', start) - start);
+  return bound == "+Inf" ? INFINITY : std::stod(bound);
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(MetricsExporter, Exposition) {
+  auto path = ::testing::TempDir() + "benchmarked_exporter_test.prom";
+  auto &handler = CodeBenchmarkHandler::GetInstance();
+  for (int i = 0; i < 3; ++i) {
+    handler.start("exporter test", 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    handler.stop("exporter test", 3);
+  }
+  std::string exposition;
+  {
+    MetricsExporter exporter(path, std::chrono::hours(1));
+    exposition = exporter.Collect();
+  }
+
+  std::string labels = "{scope=\"exporter test\",clock=\"wall\"";
+  EXPECT_NE(exposition.find("# TYPE benchmarked_scope_duration_seconds histogram\n"), std::string::npos);
+  auto buckets = linesStartingWith(exposition, "benchmarked_scope_duration_seconds_bucket" + labels);
+  ASSERT_GT(buckets.size(), 2);
+  // cumulative counts of all intervals up to and including the bound, ending with +Inf
+  double previousBound = 0;
+  double previousCount = 0;
+  for (const auto &line: buckets) {
+    EXPECT_GT(bound(line), previousBound);
+    EXPECT_GE(value(line), previousCount);
+    if (bound(line) < 0.002) { EXPECT_EQ(value(line), 0) << line; }
+    if (bound(line) >= 1) { EXPECT_EQ(value(line), 3) << line; }
+    previousBound = bound(line);
+    previousCount = value(line);
+  }
+  EXPECT_EQ(bound(buckets.back()), INFINITY);
+  EXPECT_EQ(value(buckets.back()), 3);
+  // 2^20 - 1 ns, the values up to and including it are exactly the ones below a bucket boundary
+  EXPECT_EQ(linesStartingWith(exposition, "benchmarked_scope_duration_seconds_bucket" + labels + ",le=\"0.001048575\"}")
+                .size(), 1);
+
+  auto sum = linesStartingWith(exposition, "benchmarked_scope_duration_seconds_sum" + labels + "}");
+  ASSERT_EQ(sum.size(), 1);
+  EXPECT_GE(value(sum.front()), 0.006);
+  EXPECT_LT(value(sum.front()), 1);
+  auto count = linesStartingWith(exposition, "benchmarked_scope_duration_seconds_count" + labels + "}");
+  ASSERT_EQ(count.size(), 1);
+  EXPECT_EQ(value(count.front()), 3);
+  auto calls = linesStartingWith(exposition, "benchmarked_scope_window_calls" + labels + "}");
+  ASSERT_EQ(calls.size(), 1);
+  EXPECT_EQ(value(calls.front()), 3);
+
+  // the destructor publishes a final exposition to the file, with an empty window
+  std::ifstream file(path);
+  std::stringstream published;
+  published << file.rdbuf();
+  calls = linesStartingWith(published.str(), "benchmarked_scope_window_calls" + labels + "}");
+  ASSERT_EQ(calls.size(), 1);
+  EXPECT_EQ(value(calls.front()), 0);
+  std::filesystem::remove(path);
+}
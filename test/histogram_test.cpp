@@ -0,0 +1,123 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cstdint>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/histogram.h"
+
+using benchmarked::ConcurrentLatencyHistogram;
+using benchmarked::LatencyHistogram;
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.Min(), 0);
+  EXPECT_EQ(histogram.Max(), 0);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 0; value < LatencyHistogram::kSubBuckets; ++value) { histogram.Record(value); }
+  for (uint64_t bound = 0; bound <= LatencyHistogram::kSubBuckets; ++bound) {
+    EXPECT_EQ(histogram.CountBelow(bound), bound);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, PowersOfTwoAreBucketBounds) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 0; value < 4096; ++value) { histogram.Record(value); }
+  for (uint64_t bound = 1; bound <= 4096; bound *= 2) {
+    EXPECT_EQ(histogram.CountBelow(bound), bound);
+  }
+  // the largest values end up in the last bucket
+  histogram.Record(UINT64_MAX);
+  EXPECT_EQ(histogram.Max(), UINT64_MAX);
+  EXPECT_EQ(histogram.Count(), 4097);
+  EXPECT_EQ(histogram.CountBelow(uint64_t(1) << 63), 4096);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, CountAtMostIncludesTheBound) {
+  LatencyHistogram histogram;
+  histogram.Record(1023);
+  histogram.Record(1024);
+  histogram.Record(1025);
+  EXPECT_EQ(histogram.CountAtMost(1022), 0);
+  EXPECT_EQ(histogram.CountAtMost(1023), 1);
+  EXPECT_EQ(histogram.CountAtMost(2047), 3);
+  EXPECT_EQ(histogram.CountAtMost(UINT64_MAX), 3);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, PercentileWithinBucketError) {
+  std::mt19937_64 rng(3);
+  std::uniform_int_distribution<uint64_t> uniform(1000, 1000000);
+  LatencyHistogram histogram;
+  for (int i = 0; i < 100000; ++i) { histogram.Record(uniform(rng)); }
+  const double error = 1.0 / LatencyHistogram::kSubBuckets;
+  EXPECT_NEAR(histogram.Percentile(50), 500500, 500500 * (error + 0.01));
+  EXPECT_NEAR(histogram.Percentile(99), 990010, 990010 * (error + 0.01));
+  EXPECT_GE(histogram.Percentile(0), static_cast<double>(histogram.Min()));
+  EXPECT_LE(histogram.Percentile(100), static_cast<double>(histogram.Max()));
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, MergeEqualsRecordingAll) {
+  std::mt19937_64 rng(4);
+  std::exponential_distribution<double> exponential(1e-4);
+  LatencyHistogram all;
+  LatencyHistogram a;
+  LatencyHistogram b;
+  for (int i = 0; i < 10000; ++i) {
+    auto value = static_cast<uint64_t>(exponential(rng));
+    all.Record(value);
+    (i % 3 == 0 ? a : b).Record(value);
+  }
+  a.Merge(b);
+  EXPECT_EQ(a.Count(), all.Count());
+  EXPECT_EQ(a.Min(), all.Min());
+  EXPECT_EQ(a.Max(), all.Max());
+  EXPECT_DOUBLE_EQ(a.Sum(), all.Sum());
+  for (double p: {0.0, 10.0, 50.0, 90.0, 99.0, 100.0}) {
+    EXPECT_DOUBLE_EQ(a.Percentile(p), all.Percentile(p));
+  }
+
+  LatencyHistogram empty;
+  empty.Merge(LatencyHistogram());
+  EXPECT_EQ(empty.Count(), 0);
+  EXPECT_EQ(empty.Min(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(LatencyHistogram, Since) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 0; value < 100; ++value) { histogram.Record(value); }
+  LatencyHistogram earlier = histogram;
+  for (uint64_t value = 1000; value < 1100; ++value) { histogram.Record(value); }
+  auto window = histogram.Since(earlier);
+  EXPECT_EQ(window.Count(), 100);
+  EXPECT_EQ(window.CountBelow(512), 0);
+  EXPECT_GE(window.Min(), 512);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(ConcurrentLatencyHistogram, SnapshotEqualsLatencyHistogram) {
+  ConcurrentLatencyHistogram concurrent;
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value < 100000; value *= 3) {
+    concurrent.Record(value);
+    histogram.Record(value);
+  }
+  auto snapshot = concurrent.Snapshot();
+  EXPECT_EQ(snapshot.Count(), histogram.Count());
+  EXPECT_EQ(snapshot.Min(), histogram.Min());
+  EXPECT_EQ(snapshot.Max(), histogram.Max());
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(50), histogram.Percentile(50));
+}
@@ -0,0 +1,111 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <filesystem>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/history.h"
+
+using benchmarked::HistoryRecord;
+using benchmarked::HistoryStore;
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+std::string storePath(const std::string &name) {
+  auto path = ::testing::TempDir() + "benchmarked_history_test_" + name;
+  std::filesystem::remove(path);
+  return path;
+}
+
+// _____________________________________________________________________________________________________________________
+HistoryRecord record(const std::string &name, int64_t timestamp, double median_ns) {
+  HistoryRecord record;
+  record.timestamp = timestamp;
+  record.name = name;
+  record.gitSha = "0123abc";
+  record.iterations = 10;
+  record.wallMin_ns = median_ns / 2;
+  record.wallMean_ns = median_ns;
+  record.wallMedian_ns = median_ns;
+  record.cpuMedian_ns = median_ns;
+  return record;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(HistoryStore, RoundTrip) {
+  auto path = storePath("round_trip");
+  {
+    HistoryStore store(path);
+    store.Append(record("b", 30, 3));
+    store.Append(record("a", 20, 2));
+    store.Append(record("b", 10, 1));
+  }
+  HistoryStore store(path, true);
+  EXPECT_EQ(store.Names(), (std::vector<std::string>{"a", "b"}));
+  auto b = store.Query("b");
+  ASSERT_EQ(b.size(), 2);
+  // sorted by timestamp, not by the order of the appends
+  EXPECT_EQ(b[0].timestamp, 10);
+  EXPECT_EQ(b[1].timestamp, 30);
+  EXPECT_EQ(b[0].gitSha, "0123abc");
+  EXPECT_EQ(b[0].iterations, 10);
+  EXPECT_DOUBLE_EQ(b[1].wallMedian_ns, 3);
+  EXPECT_DOUBLE_EQ(b[1].wallMin_ns, 1.5);
+  EXPECT_EQ(store.Query("b", 20).size(), 1);
+  EXPECT_EQ(store.Query("b", 0, 20).size(), 1);
+  EXPECT_TRUE(store.Query("c").empty());
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(HistoryStore, RecoversFromTruncatedTail) {
+  auto path = storePath("truncated_tail");
+  {
+    HistoryStore store(path);
+    store.Append(record("a", 1, 1));
+    store.Append(record("a", 2, 2));
+  }
+  // a crash in the middle of the second append
+  auto size = std::filesystem::file_size(path);
+  std::filesystem::resize_file(path, size - 10);
+  {
+    HistoryStore store(path, true);
+    EXPECT_EQ(store.Query("a").size(), 1);
+    EXPECT_THROW(store.Append(record("a", 3, 3)), std::runtime_error);
+  }
+  // opening for writing removes the partial record, so the next one is read correctly
+  {
+    HistoryStore store(path);
+    store.Append(record("a", 3, 3));
+  }
+  HistoryStore store(path, true);
+  auto a = store.Query("a");
+  ASSERT_EQ(a.size(), 2);
+  EXPECT_EQ(a[0].timestamp, 1);
+  EXPECT_EQ(a[1].timestamp, 3);
+  EXPECT_DOUBLE_EQ(a[1].wallMedian_ns, 3);
+  std::filesystem::remove(path);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(HistoryStore, ReadOnlyDoesNotCreate) {
+  auto path = storePath("read_only");
+  EXPECT_THROW(HistoryStore(path, true), std::runtime_error);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(DetectChangePoints, FindsStep) {
+  std::vector<HistoryRecord> history;
+  for (int i = 0; i < 20; ++i) { history.push_back(record("a", i, (i < 10 ? 100 : 120) + i % 2)); }
+  auto changes = benchmarked::DetectChangePoints(history);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].index, 10);
+  EXPECT_NEAR(changes[0].before_ns, 100.5, 0.5);
+  EXPECT_NEAR(changes[0].after_ns, 120.5, 0.5);
+}
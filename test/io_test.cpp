@@ -0,0 +1,88 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/io.h"
+
+using benchmarked::IOCounters;
+
+// _____________________________________________________________________________________________________________________
+TEST(IOCounters, Parse) {
+  std::stringstream proc("rchar: 323934931\n"
+                         "wchar: 323929600\n"
+                         "syscr: 632687\n"
+                         "syscw: 632675\n"
+                         "read_bytes: 4096\n"
+                         "write_bytes: 323932160\n"
+                         "cancelled_write_bytes: 8192\n");
+  auto counters = IOCounters::Parse(proc);
+  EXPECT_EQ(counters.rchar, 323934931);
+  EXPECT_EQ(counters.wchar, 323929600);
+  EXPECT_EQ(counters.syscr, 632687);
+  EXPECT_EQ(counters.syscw, 632675);
+  EXPECT_EQ(counters.readBytes, 4096);
+  EXPECT_EQ(counters.writeBytes, 323932160);
+  EXPECT_EQ(counters.cancelledWriteBytes, 8192);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(IOCounters, ParseIgnoresUnknownAndMissingFields) {
+  std::stringstream proc("rchar: 10\nfuture_counter: 99\nwrite_bytes: 20\n");
+  auto counters = IOCounters::Parse(proc);
+  EXPECT_EQ(counters.rchar, 10);
+  EXPECT_EQ(counters.writeBytes, 20);
+  EXPECT_EQ(counters.wchar, 0);
+  EXPECT_EQ(counters.syscr, 0);
+  EXPECT_EQ(counters.readBytes, 0);
+
+  std::stringstream empty;
+  EXPECT_EQ(IOCounters::Parse(empty).rchar, 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(IOCounters, DifferenceSaturatesAndSumAccumulates) {
+  IOCounters before;
+  before.rchar = 100;
+  before.wchar = 50;
+  IOCounters after;
+  after.rchar = 150;
+  after.wchar = 20;  // e.g. another counter source after a reset
+  auto delta = after - before;
+  EXPECT_EQ(delta.rchar, 50);
+  EXPECT_EQ(delta.wchar, 0);
+
+  IOCounters total;
+  total += delta;
+  total += delta;
+  EXPECT_EQ(total.rchar, 100);
+  EXPECT_EQ(total.wchar, 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(IOCounters, ReadCountsWritesOfThisProcess) {
+  auto before = IOCounters::Read();
+  if (!before) { GTEST_SKIP() << "/proc/self/io is not available"; }
+
+  std::string path = ::testing::TempDir() + "benchmarked_io_test";
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  ASSERT_GE(fd, 0);
+  std::vector<char> data(64 * 1024, 'x');
+  for (int i = 0; i < 4; ++i) { ASSERT_EQ(::write(fd, data.data(), data.size()), data.size()); }
+  ::close(fd);
+  std::filesystem::remove(path);
+
+  auto after = IOCounters::Read();
+  ASSERT_TRUE(after);
+  auto delta = *after - *before;
+  EXPECT_GE(delta.wchar, 4 * data.size());
+  EXPECT_GE(delta.syscw, 4);
+}
@@ -0,0 +1,167 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/memory.h"
+
+using benchmarked::ArenaResource;
+using benchmarked::PoolResource;
+
+namespace {
+
+/**
+ * CountingResource: new/delete backed resource that counts the calls and the bytes not yet returned.
+ */
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t outstanding = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// _____________________________________________________________________________________________________________________
+bool aligned(void* p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(ArenaResource, Alignment) {
+  ArenaResource arena(256);
+  for (std::size_t alignment = 1; alignment <= 4096; alignment *= 2) {
+    // an odd size first, so the next allocation starts misaligned
+    static_cast<void>(arena.allocate(3, 1));
+    void* p = arena.allocate(alignment + 5, alignment);
+    EXPECT_TRUE(aligned(p, alignment)) << alignment;
+  }
+  EXPECT_GE(arena.Capacity(), arena.Used());
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(ArenaResource, ResetReusesMemory) {
+  CountingResource upstream;
+  ArenaResource arena(1024, &upstream);
+  auto iteration = [&arena]() {
+    for (int i = 0; i < 100; ++i) { static_cast<void>(arena.allocate(100, 8)); }
+  };
+
+  iteration();
+  EXPECT_GT(upstream.allocations, 1);
+  EXPECT_GE(arena.Used(), 100 * 100);
+  std::size_t capacity = arena.Capacity();
+
+  // the chunks are merged into one of the same capacity, the next iteration of the same size fits into it
+  arena.Reset();
+  EXPECT_EQ(arena.Used(), 0);
+  EXPECT_EQ(arena.Capacity(), capacity);
+  std::size_t allocations = upstream.allocations;
+  iteration();
+  arena.Reset();
+  iteration();
+  EXPECT_EQ(upstream.allocations, allocations);
+  EXPECT_EQ(upstream.outstanding, capacity);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(ArenaResource, ReleaseReturnsAllMemory) {
+  CountingResource upstream;
+  {
+    ArenaResource arena(64, &upstream);
+    for (int i = 0; i < 10; ++i) { static_cast<void>(arena.allocate(1000, 16)); }
+    arena.Release();
+    EXPECT_EQ(upstream.outstanding, 0);
+    EXPECT_EQ(arena.Capacity(), 0);
+    EXPECT_EQ(arena.Used(), 0);
+
+    // usable after Release()
+    EXPECT_TRUE(aligned(arena.allocate(10, 8), 8));
+    EXPECT_GT(upstream.outstanding, 0);
+  }
+  EXPECT_EQ(upstream.outstanding, 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(PoolResource, SizeClassBoundaries) {
+  PoolResource pool;
+
+  // blocks are recycled within their size class: 1 .. 16 bytes share the smallest class
+  void* p = pool.allocate(1, 1);
+  pool.deallocate(p, 1, 1);
+  EXPECT_EQ(pool.allocate(PoolResource::MIN_BLOCK_SIZE, 1), p);
+
+  // one byte more is the next class
+  void* q = pool.allocate(PoolResource::MIN_BLOCK_SIZE + 1, 1);
+  pool.deallocate(q, PoolResource::MIN_BLOCK_SIZE + 1, 1);
+  EXPECT_NE(pool.allocate(PoolResource::MIN_BLOCK_SIZE, 1), q);
+  EXPECT_EQ(pool.allocate(2 * PoolResource::MIN_BLOCK_SIZE, 1), q);
+
+  // the largest class
+  void* largest = pool.allocate(PoolResource::MAX_BLOCK_SIZE, 1);
+  pool.deallocate(largest, PoolResource::MAX_BLOCK_SIZE, 1);
+  EXPECT_EQ(pool.allocate(PoolResource::MAX_BLOCK_SIZE / 2 + 1, 1), largest);
+
+  // larger blocks are not recycled before Reset()
+  void* large = pool.allocate(PoolResource::MAX_BLOCK_SIZE + 1, 1);
+  pool.deallocate(large, PoolResource::MAX_BLOCK_SIZE + 1, 1);
+  EXPECT_NE(pool.allocate(PoolResource::MAX_BLOCK_SIZE + 1, 1), large);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(PoolResource, Alignment) {
+  PoolResource pool;
+  for (std::size_t alignment = 1; alignment <= 2 * PoolResource::MAX_BLOCK_SIZE; alignment *= 2) {
+    for (std::size_t bytes: {std::size_t{1}, alignment, 3 * alignment + 1}) {
+      EXPECT_TRUE(aligned(pool.allocate(bytes, alignment), alignment)) << bytes << " " << alignment;
+    }
+  }
+
+  // the alignment selects the size class if it is larger than the block
+  void* p = pool.allocate(8, 64);
+  pool.deallocate(p, 8, 64);
+  EXPECT_EQ(pool.allocate(64, 1), p);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(PoolResource, ResetAndRelease) {
+  CountingResource upstream;
+  PoolResource pool(&upstream);
+  auto iteration = [&]() {
+    for (std::size_t bytes = 1; bytes <= 2 * PoolResource::MAX_BLOCK_SIZE; bytes *= 2) {
+      for (int i = 0; i < 20; ++i) { static_cast<void>(pool.allocate(bytes, 8)); }
+    }
+  };
+
+  iteration();
+  pool.Reset();
+  std::size_t allocations = upstream.allocations;
+  iteration();
+  pool.Reset();
+  iteration();
+  EXPECT_EQ(upstream.allocations, allocations);
+
+  pool.Release();
+  EXPECT_EQ(upstream.outstanding, 0);
+  // the free lists were dropped as well: nothing handed out before Release() is reused
+  EXPECT_TRUE(aligned(pool.allocate(16, 16), 16));
+}
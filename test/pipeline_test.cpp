@@ -0,0 +1,105 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/benchmark.h"
+#include "benchmarked/pipeline.h"
+
+using benchmarked::Benchmark;
+using benchmarked::BenchmarkBase;
+using benchmarked::BenchmarkOptions;
+using benchmarked::PipelinedFixture;
+
+namespace {
+
+/**
+ * Sequence: every input is the number of inputs prepared before it, Run() records the inputs in the order it gets
+ *  them.
+ */
+class Sequence : public Benchmark, public PipelinedFixture<uint64_t> {
+ public:
+  Sequence(uint64_t iterations, BenchmarkOptions options, uint64_t failAt = UINT64_MAX)
+    : Benchmark("pipeline", "", "", iterations, std::move(options)), _failAt(failAt) {}
+
+  std::atomic<uint64_t> prepared{0};
+  std::vector<uint64_t> inputs;
+  // most inputs prepared but not yet used by Run()
+  uint64_t maxAhead = 0;
+
+ protected:
+  uint64_t Prepare() override {
+    // a slow producer in the beginning, then a fast one that has to wait for free slots
+    if (prepared < 2) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+    if (prepared == _failAt) { throw std::runtime_error("prepare failed"); }
+    return prepared++;
+  }
+
+  void Run() override {
+    inputs.push_back(CurrentInput());
+    maxAhead = std::max(maxAhead, prepared.load() - inputs.size());
+  }
+
+ private:
+  uint64_t _failAt;
+};
+
+// _____________________________________________________________________________________________________________________
+// Benchmark::Launch() is only reachable through the interface the Launcher uses
+void launch(BenchmarkBase &benchmark) {
+  benchmark.Launch();
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+TEST(Pipeline, InputsAreUsedInTheOrderTheyArePrepared) {
+  Sequence benchmark(50, BenchmarkOptions{.pipelineDepth = 3});
+  launch(benchmark);
+
+  ASSERT_EQ(benchmark.inputs.size(), 50);
+  for (uint64_t i = 0; i < benchmark.inputs.size(); ++i) { EXPECT_EQ(benchmark.inputs[i], i); }
+  EXPECT_LE(benchmark.maxAhead, 3);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Pipeline, ColdIterationsGetTheirOwnInputs) {
+  Sequence benchmark(5, BenchmarkOptions{.coldCache = true, .pipelineDepth = 1});
+  launch(benchmark);
+
+  // hot and cold iterations alternate, each one with a fresh input
+  ASSERT_EQ(benchmark.inputs.size(), 10);
+  for (uint64_t i = 0; i < benchmark.inputs.size(); ++i) { EXPECT_EQ(benchmark.inputs[i], i); }
+  EXPECT_LE(benchmark.maxAhead, 1);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Pipeline, StopsAtTheEndOfTheInputs) {
+  Sequence benchmark(20, BenchmarkOptions{.pipelineDepth = 8});
+  launch(benchmark);
+  // nothing is prepared for iterations that do not exist
+  EXPECT_EQ(benchmark.prepared, 20);
+  EXPECT_EQ(benchmark.inputs.size(), 20);
+
+  Sequence empty(0, BenchmarkOptions{});
+  launch(empty);
+  EXPECT_EQ(empty.prepared, 0);
+  EXPECT_TRUE(empty.inputs.empty());
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Pipeline, ExceptionsOfTheProducerReachTheMeasuringThread) {
+  Sequence benchmark(20, BenchmarkOptions{.pipelineDepth = 2}, 7);
+  EXPECT_THROW(launch(benchmark), std::runtime_error);
+  // the inputs prepared before the failure are all used
+  ASSERT_EQ(benchmark.inputs.size(), 7);
+  for (uint64_t i = 0; i < benchmark.inputs.size(); ++i) { EXPECT_EQ(benchmark.inputs[i], i); }
+}
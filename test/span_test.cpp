@@ -0,0 +1,72 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/benchmark.h"
+
+using benchmarked::Span;
+using benchmarked::SpanSite;
+
+// _____________________________________________________________________________________________________________________
+TEST(Span, StoppedOnAnotherThread) {
+  SpanSite site;
+  std::vector<Span> spans;
+  for (int i = 0; i < 8; ++i) { spans.push_back(site.Start()); }
+  EXPECT_EQ(site.getOpen(), 8);
+  std::thread other([&spans]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (auto &span: spans) { span.Stop(); }
+  });
+  other.join();
+  EXPECT_EQ(site.getOpen(), 0);
+  auto histogram = site.getHistogram();
+  EXPECT_EQ(histogram.Count(), 8);
+  EXPECT_GE(histogram.Min(), 1000 * 1000 / 2);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Span, MovedToAnotherThread) {
+  SpanSite site;
+  Span span = site.Start();
+  std::thread other([span = std::move(span)]() mutable { span.Stop(); });
+  other.join();
+  // the moved-from span does not stop the interval again
+  span.Stop();
+  EXPECT_EQ(site.getHistogram().Count(), 1);
+  EXPECT_EQ(site.getOpen(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Span, StoppedWhenDestroyedWhileOpen) {
+  SpanSite site;
+  {
+    Span span = site.Start();
+    EXPECT_EQ(site.getOpen(), 1);
+  }
+  EXPECT_EQ(site.getOpen(), 0);
+  EXPECT_EQ(site.getHistogram().Count(), 1);
+  {
+    Span span = site.Start();
+    span.Stop();
+  }
+  // a stopped span is not recorded again by its destructor
+  EXPECT_EQ(site.getHistogram().Count(), 2);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Span, StoppedWhenReplaced) {
+  SpanSite site;
+  Span span = site.Start();
+  span = site.Start();
+  EXPECT_EQ(site.getHistogram().Count(), 1);
+  EXPECT_EQ(site.getOpen(), 1);
+  span = Span();
+  EXPECT_EQ(site.getHistogram().Count(), 2);
+  EXPECT_EQ(site.getOpen(), 0);
+}
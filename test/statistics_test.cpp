@@ -0,0 +1,123 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "benchmarked/statistics.h"
+
+using namespace benchmarked::statistics;
+
+// _____________________________________________________________________________________________________________________
+TEST(Percentile, InterpolatesBetweenClosestRanks) {
+  std::vector<double> values = {4, 1, 3, 2};
+  EXPECT_DOUBLE_EQ(Percentile(values, 0), 1);
+  EXPECT_DOUBLE_EQ(Percentile(values, 50), 2.5);
+  EXPECT_DOUBLE_EQ(Percentile(values, 100), 4);
+  EXPECT_DOUBLE_EQ(Percentile(values, 25), 1.75);
+  // p is clamped to [0, 100]
+  EXPECT_DOUBLE_EQ(Percentile(values, -5), 1);
+  EXPECT_DOUBLE_EQ(Percentile(values, 150), 4);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Percentile, EmptyAndSingleValue) {
+  EXPECT_DOUBLE_EQ(Percentile({}, 50), 0);
+  EXPECT_DOUBLE_EQ(Percentile({7}, 0), 7);
+  EXPECT_DOUBLE_EQ(Percentile({7}, 99), 7);
+  EXPECT_DOUBLE_EQ(PercentileSorted({1, 2, 3}, 50), 2);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, Empty) {
+  auto summary = Summarize({});
+  EXPECT_EQ(summary.count, 0);
+  EXPECT_EQ(summary.Outliers(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, ConstantSamples) {
+  auto summary = Summarize({5, 5, 5, 5});
+  EXPECT_EQ(summary.count, 4);
+  EXPECT_DOUBLE_EQ(summary.min, 5);
+  EXPECT_DOUBLE_EQ(summary.max, 5);
+  EXPECT_DOUBLE_EQ(summary.mean, 5);
+  EXPECT_DOUBLE_EQ(summary.median, 5);
+  EXPECT_DOUBLE_EQ(summary.stddev, 0);
+  EXPECT_DOUBLE_EQ(summary.medianAbsolutePercentError, 0);
+  EXPECT_EQ(summary.Outliers(), 0);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, NormalSamples) {
+  std::mt19937_64 rng(1);
+  std::normal_distribution<double> normal(100, 5);
+  std::vector<double> samples;
+  for (int i = 0; i < 1000; ++i) { samples.push_back(normal(rng)); }
+  auto summary = Summarize(samples);
+  EXPECT_EQ(summary.count, 1000);
+  EXPECT_NEAR(summary.mean, 100, 1);
+  EXPECT_NEAR(summary.median, 100, 1);
+  EXPECT_NEAR(summary.stddev, 5, 0.5);
+  EXPECT_DOUBLE_EQ(summary.median, Percentile(samples, 50));
+  EXPECT_LE(summary.meanCI.low, summary.mean);
+  EXPECT_GE(summary.meanCI.high, summary.mean);
+  EXPECT_LE(summary.medianCI.low, summary.median);
+  EXPECT_GE(summary.medianCI.high, summary.median);
+  EXPECT_DOUBLE_EQ(summary.meanCI.confidence, 0.95);
+  EXPECT_EQ(summary.modes, 1);
+  EXPECT_NEAR(summary.autocorrelation, 0, 0.1);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, IntervalMethods) {
+  std::vector<double> samples;
+  for (int i = 0; i < 100; ++i) { samples.push_back(i % 7); }
+  auto summary = Summarize(samples);
+  EXPECT_EQ(summary.medianCI.method, IntervalMethod::ExactBootstrap);
+  EXPECT_EQ(summary.meanCI.method, IntervalMethod::PercentileBootstrap);
+  // 100 samples times 2^19 resamples exceed the 2^25 draws of the bootstrap
+  summary = Summarize(samples, 0.95, 1U << 19);
+  EXPECT_EQ(summary.meanCI.method, IntervalMethod::NormalApproximation);
+  EXPECT_LT(summary.meanCI.low, summary.mean);
+  EXPECT_GT(summary.meanCI.high, summary.mean);
+  EXPECT_STREQ(ToString(IntervalMethod::NormalApproximation), "normal approximation");
+  EXPECT_EQ(Summarize({}).meanCI.method, IntervalMethod::None);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, CountsOutliers) {
+  std::vector<double> samples;
+  for (int i = 0; i < 100; ++i) { samples.push_back(100 + i % 10); }
+  samples.push_back(1000);
+  samples.push_back(0);
+  auto summary = Summarize(samples);
+  EXPECT_EQ(summary.highSevere, 1);
+  EXPECT_EQ(summary.lowSevere, 1);
+  EXPECT_EQ(summary.Outliers(), 2);
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(Summarize, DetectsTwoModes) {
+  std::mt19937_64 rng(2);
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<double> samples;
+  for (int i = 0; i < 1000; ++i) { samples.push_back(normal(rng) + (i % 2 == 0 ? 100 : 140)); }
+  EXPECT_TRUE(Summarize(samples).Multimodal());
+}
+
+// _____________________________________________________________________________________________________________________
+TEST(BootstrapPairedRatio, RatioOfPairs) {
+  std::vector<double> a;
+  std::vector<double> b;
+  for (int i = 1; i <= 50; ++i) {
+    a.push_back(i);
+    b.push_back(2 * i);
+  }
+  auto ratio = BootstrapPairedRatio(a, b);
+  EXPECT_NEAR(ratio.value, 2, 1e-9);
+  EXPECT_NEAR(ratio.low, 2, 1e-9);
+  EXPECT_NEAR(ratio.high, 2, 1e-9);
+}
@@ -0,0 +1,81 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+// benchmarked-history: query a history store written by benchmark binaries run with --history <store>
+//
+//   benchmarked-history <store> list                 list all benchmarks in the store
+//   benchmarked-history <store> show <name>          print the history of a benchmark
+//   benchmarked-history <store> changes [<name>]     run change point detection (on all benchmarks if no name given)
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmarked/history.h"
+
+// _____________________________________________________________________________________________________________________
+std::string formatTime(int64_t timestamp) {
+  std::time_t time = timestamp;
+  std::tm tm{};
+  localtime_r(&time, &tm);
+  std::stringstream ss;
+  ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+  return ss.str();
+}
+
+// _____________________________________________________________________________________________________________________
+void printChanges(benchmarked::HistoryStore &store, const std::string &name) {
+  auto history = store.Query(name);
+  auto changes = benchmarked::DetectChangePoints(history);
+  if (changes.empty()) { return; }
+  std::cout << name << " (" << history.size() << " runs)\n";
+  for (const auto &change: changes) {
+    double relative = (change.after_ns - change.before_ns) / change.before_ns * 100;
+    std::cout << "  " << formatTime(change.timestamp) << "  " << std::setw(12) << change.gitSha.substr(0, 12) << "  "
+              << change.before_ns / 1000 / 1000 << " ms -> " << change.after_ns / 1000 / 1000 << " ms ("
+              << (relative > 0 ? "+" : "") << relative << "%)\n";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <store> list|show <name>|changes [<name>]" << std::endl;
+    return 1;
+  }
+  try {
+    benchmarked::HistoryStore store(argv[1], true);
+    std::string command = argv[2];
+    if (command == "list") {
+      for (const auto &name: store.Names()) {
+        std::cout << name << " (" << store.Query(name).size() << " runs)\n";
+      }
+    } else if (command == "show" && argc > 3) {
+      std::cout << std::left << std::setw(21) << "time" << std::setw(14) << "git sha" << std::right
+                << std::setw(12) << "iterations" << std::setw(16) << "wall min [ms]" << std::setw(16)
+                << "wall med [ms]" << std::setw(16) << "cpu med [ms]" << "\n";
+      for (const auto &record: store.Query(argv[3])) {
+        std::cout << std::left << std::setw(21) << formatTime(record.timestamp) << std::setw(14)
+                  << record.gitSha.substr(0, 12) << std::right << std::setw(12) << record.iterations
+                  << std::setw(16) << record.wallMin_ns / 1000 / 1000 << std::setw(16)
+                  << record.wallMedian_ns / 1000 / 1000 << std::setw(16) << record.cpuMedian_ns / 1000 / 1000
+                  << "\n";
+      }
+    } else if (command == "changes") {
+      if (argc > 3) {
+        printChanges(store, argv[3]);
+      } else {
+        for (const auto &name: store.Names()) { printChanges(store, name); }
+      }
+    } else {
+      std::cerr << "unknown command: " << command << std::endl;
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
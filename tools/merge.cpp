@@ -0,0 +1,96 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+// benchmarked-merge: combine the checkpoints written by benchmark binaries run with --checkpoint <file> (e.g. one per
+//  shard) into one report. A benchmark found in more than one checkpoint is taken from the last one given.
+//
+// The report shows the environment and host profile recorded in the first checkpoint. Checkpoints recorded on a host
+//  whose environment differs or whose host profile deviates by more than the tolerance (default 0.25, i.e. 25%) are
+//  reported on stderr, with --strict they are not merged at all. A csv report written to a file gets its metadata in
+//  <file>.meta.csv, one written to stdout on stderr.
+//
+//   benchmarked-merge [-f console|csv] [-o <file>] [--strict] [--tolerance <fraction>] <checkpoint>...
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmarked/checkpoint.h"
+#include "benchmarked/launcher.h"
+
+// _____________________________________________________________________________________________________________________
+int main(int argc, char **argv) {
+  std::string format = "console";
+  std::string output;
+  bool strict = false;
+  double tolerance = 0.25;
+  std::vector<std::string> checkpoints;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if ((arg == "-f" || arg == "--format") && i + 1 < argc) {
+      format = argv[++i];
+    } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+      output = argv[++i];
+    } else if (arg == "--strict") {
+      strict = true;
+    } else if (arg == "--tolerance" && i + 1 < argc) {
+      tolerance = std::stod(argv[++i]);
+    } else {
+      checkpoints.push_back(arg);
+    }
+  }
+  if (checkpoints.empty() || (format != "console" && format != "csv")) {
+    std::cerr << "usage: " << argv[0] << " [-f console|csv] [-o <file>] [--strict] [--tolerance <fraction>] "
+              << "<checkpoint>..." << std::endl;
+    return 1;
+  }
+  try {
+    // checkpoints without any record have no environment either
+    benchmarked::RecordedEnvironment reference;
+    std::string referencePath;
+    bool differ = false;
+    for (const auto &path: checkpoints) {
+      auto environment = benchmarked::Checkpoint::LoadEnvironment(path);
+      if (environment.Empty()) { continue; }
+      if (referencePath.empty()) {
+        reference = std::move(environment);
+        referencePath = path;
+        continue;
+      }
+      auto differences = environment.Differences(reference, tolerance);
+      if (differences.empty()) { continue; }
+      differ = true;
+      std::cerr << (strict ? "error: '" : "warning: '") << path << "' was recorded on a different host than '"
+                << referencePath << "':\n";
+      for (const auto &difference: differences) { std::cerr << "  " << difference << "\n"; }
+    }
+    if (differ && strict) {
+      std::cerr << "Not merging results of different hosts (--strict)." << std::endl;
+      return 1;
+    }
+
+    benchmarked::Launcher launcher("merged");
+    for (const auto &benchmark: benchmarked::Checkpoint::Merge(checkpoints)) { launcher.RegisterBenchmark(benchmark); }
+    std::ofstream file;
+    if (!output.empty()) { file.open(output); }
+    std::ostream &os = output.empty() ? std::cout : file;
+    if (format == "console") {
+      auto reporter = std::make_unique<benchmarked::ConsoleReporter>(os);
+      reporter->SetRecordedEnvironment(reference);
+      launcher.Report(std::move(reporter));
+      launcher.Compare(std::make_unique<benchmarked::CompareReporter>(os));
+    } else {
+      std::ofstream metadata;
+      if (!output.empty()) { metadata.open(output + ".meta.csv"); }
+      auto reporter = std::make_unique<benchmarked::CSVReporter>(os, ",", output.empty() ? &std::cerr : &metadata);
+      reporter->SetRecordedEnvironment(reference);
+      launcher.Report(std::move(reporter));
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+
+// benchmarked-ring: print live statistics of the code benchmarks of a process that publishes them to an event ring
+//  (started with BENCHMARKED_EVENT_RING=1 or calling benchmarked::EventRing::Enable())
+//
+//   benchmarked-ring <pid>|<file> [<interval seconds>]
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+
+#include "benchmarked/event_ring.h"
+#include "benchmarked/histogram.h"
+
+struct Scope {
+  benchmarked::LatencyHistogram total;
+  benchmarked::LatencyHistogram window;
+};
+
+// _____________________________________________________________________________________________________________________
+void printScopes(std::map<std::string, Scope> &scopes, double interval_s, uint64_t dropped) {
+  std::cout << "\n" << std::left << std::setw(40) << "scope" << std::right << std::setw(12) << "calls/s"
+            << std::setw(12) << "mean [us]" << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]"
+            << std::setw(12) << "max [us]" << std::setw(14) << "total calls" << "\n";
+  for (auto &[name, scope]: scopes) {
+    const auto &window = scope.window;
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12)
+              << static_cast<double>(window.Count()) / interval_s << std::setw(12) << window.Mean() / 1000
+              << std::setw(12) << window.Percentile(50) / 1000 << std::setw(12) << window.Percentile(99) / 1000
+              << std::setw(12) << static_cast<double>(window.Max()) / 1000 << std::setw(14) << scope.total.Count()
+              << "\n";
+    scope.window = {};
+  }
+  std::cout << "dropped events: " << dropped << std::endl;
+}
+
+// _____________________________________________________________________________________________________________________
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <pid>|<file> [<interval seconds>]" << std::endl;
+    return 1;
+  }
+  std::string target = argv[1];
+  if (std::all_of(target.begin(), target.end(), ::isdigit)) {
+    target = "/dev/shm/benchmarked-" + target;
+  }
+  double interval_s = argc > 2 ? std::stod(argv[2]) : 1.0;
+  try {
+    benchmarked::EventRingReader reader(target);
+    std::map<std::string, Scope> scopes;
+    std::map<uint32_t, Scope *> scopesById;
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(interval_s));
+    auto nextPrint = std::chrono::steady_clock::now() + interval;
+    while (true) {
+      // polling much more often than printing keeps the rings from overflowing
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      // checked before polling, so the last events of the process are still printed
+      bool exited = ::kill(reader.Pid(), 0) != 0 && errno == ESRCH;
+      for (const auto &event: reader.Poll()) {
+        auto &scope = scopesById[event.nameId];
+        if (scope == nullptr) { scope = &scopes[reader.Name(event.nameId)]; }
+        scope->total.Record(event.duration_ns);
+        scope->window.Record(event.duration_ns);
+      }
+      if (std::chrono::steady_clock::now() >= nextPrint || exited) {
+        printScopes(scopes, interval_s, reader.Dropped());
+        nextPrint += interval;
+      }
+      if (exited) {
+        std::cout << "process " << reader.Pid() << " exited" << std::endl;
+        return 0;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}